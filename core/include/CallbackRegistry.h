@@ -0,0 +1,92 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef CALLBACKREGISTRY_H
+#define CALLBACKREGISTRY_H
+#include <atomic>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "ChannelTrie.h"
+#include "EpochDomain.h"
+#include "Mutex.h"
+#include "Transport.h"
+
+namespace YunaProtocol {
+
+    /**
+     * @class CallbackRegistry
+     * @brief The data callbacks of a node, by channel filter, readable without locks.
+     *
+     * The filters and callbacks form an immutable snapshot. Readers load the current snapshot
+     * inside an epoch read section and never lock or wait; writers copy it, change the copy,
+     * publish it with an atomic swap and retire the old one to the EpochDomain. Callbacks are
+     * shared, so a callback queued on the handler executor survives its removal.
+     */
+    class CallbackRegistry {
+    public:
+        using SharedCallback = std::shared_ptr<const DataReceivedCallback>;
+
+        CallbackRegistry();
+
+        ~CallbackRegistry();
+
+        CallbackRegistry(const CallbackRegistry&) = delete;
+        CallbackRegistry& operator=(const CallbackRegistry&) = delete;
+
+        /**
+         * @brief Adds the callback of a channel filter, replacing the previous one.
+         * @return False if the filter is malformed.
+         */
+        bool add(std::string_view filter, DataReceivedCallback callback);
+
+        /**
+         * @brief Removes the callback of a channel filter, compared literally.
+         * @return False if the filter has no callback.
+         */
+        bool remove(std::string_view filter);
+
+        /**
+         * @brief Number of registered filters.
+         */
+        size_t size() const;
+
+        /**
+         * @brief Calls a visitor with the callback of every filter matching a channel name.
+         *
+         * Runs against the snapshot current when it starts: callbacks added or removed by the
+         * visitor, or by other threads meanwhile, only apply to later calls.
+         * @param channel The channel name.
+         * @param visit Any callable taking a const SharedCallback&.
+         */
+        template <typename Visitor>
+        void forEachMatch(std::string_view channel, Visitor&& visit) const {
+            EpochDomain::ReadGuard guard(epochs);
+            const Snapshot *snapshot = current.load();
+            snapshot->filters.forEachMatch(channel, [snapshot, &visit](uint32_t index) {
+                visit(snapshot->callbacks[index]);
+            });
+        }
+
+        /**
+         * @brief Deletes the replaced snapshots no reader uses anymore. Cheap when there are none.
+         */
+        void reclaim();
+
+    private:
+        struct Snapshot {
+            ChannelTrie filters;
+            std::vector<SharedCallback> callbacks; // Indexed by the filters' subscriptions, null once removed.
+        };
+
+        void publish(const Snapshot *next);
+
+        mutable EpochDomain epochs;
+        std::atomic<const Snapshot *> current;
+        mutable Mutex writerMutex; // Serializes writers and reclamation.
+    };
+}
+
+#endif //CALLBACKREGISTRY_H
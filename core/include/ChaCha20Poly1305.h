@@ -0,0 +1,120 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef CHACHA20POLY1305_H
+#define CHACHA20POLY1305_H
+#include <cstddef>
+#include <cstdint>
+
+namespace YunaProtocol {
+
+    constexpr size_t AEAD_KEY_SIZE = 32;
+    constexpr size_t AEAD_NONCE_SIZE = 12;
+    constexpr size_t AEAD_TAG_SIZE = 16;
+
+    class ChaCha20Poly1305;
+
+    /**
+     * @brief One message of a batch, encrypted or decrypted in place.
+     */
+    struct AeadMessage {
+        const ChaCha20Poly1305 *cipher = nullptr; // Messages of a batch may use different keys.
+        const uint8_t *nonce = nullptr; // AEAD_NONCE_SIZE bytes, never reused with the same key.
+        const uint8_t *aad = nullptr; // Authenticated but not encrypted, e.g. a packet header.
+        size_t aadLength = 0;
+        uint8_t *data = nullptr; // Plaintext on seal, ciphertext on open; replaced in place.
+        size_t length = 0;
+        uint8_t *tag = nullptr; // AEAD_TAG_SIZE bytes, written by seal and checked by open.
+    };
+
+    /**
+     * @class ChaCha20Poly1305
+     * @brief The ChaCha20-Poly1305 AEAD of RFC 8439, under one 256-bit key.
+     *
+     * ChaCha20 blocks are computed several at a time with AVX2 (8 blocks) or SSE2 and NEON
+     * (4 blocks) when the CPU has them, and one at a time otherwise (e.g. on the ESP8266). The
+     * blocks of a batch are pooled across messages, so batches of small packets fill the vector
+     * lanes as well as one large packet does. Poly1305 uses 64-bit limbs where the compiler has
+     * a 128-bit product and 32-bit limbs elsewhere.
+     */
+    class ChaCha20Poly1305 {
+    public:
+        /**
+         * @brief An all-zero key, to be assigned a real one.
+         */
+        ChaCha20Poly1305() = default;
+
+        /**
+         * @param key AEAD_KEY_SIZE bytes.
+         */
+        explicit ChaCha20Poly1305(const uint8_t *key);
+
+        /**
+         * @brief Wipes the key.
+         */
+        ~ChaCha20Poly1305();
+
+        ChaCha20Poly1305(const ChaCha20Poly1305&) = default;
+        ChaCha20Poly1305& operator=(const ChaCha20Poly1305&) = default;
+
+        /**
+         * @brief Encrypts a message in place and computes its tag.
+         * @param nonce AEAD_NONCE_SIZE bytes.
+         * @param aad Additional data authenticated along with the message.
+         * @param aadLength The size of the additional data.
+         * @param data The plaintext, replaced by the ciphertext.
+         * @param length The size of the message.
+         * @param tag Receives AEAD_TAG_SIZE bytes.
+         */
+        void seal(const uint8_t *nonce, const uint8_t *aad, size_t aadLength,
+                  uint8_t *data, size_t length, uint8_t *tag) const;
+
+        /**
+         * @brief Verifies the tag of a message and decrypts it in place.
+         *
+         * The tag is compared in constant time, and a message that fails is left encrypted.
+         * @return False if the message, the additional data or the tag was altered or the key differs.
+         */
+        bool open(const uint8_t *nonce, const uint8_t *aad, size_t aadLength,
+                  uint8_t *data, size_t length, const uint8_t *tag) const;
+
+        /**
+         * @brief The keystream kernel selected for this CPU: "avx2", "sse2", "neon" or "scalar".
+         */
+        static const char *kernelName();
+
+        /**
+         * @brief Switches every cipher to another keystream kernel, e.g. to benchmark them.
+         *
+         * Not thread-safe: call it while nothing is being sealed or opened.
+         * @param name "avx2", "sse2", "neon" or "scalar", as returned by kernelName().
+         * @return False, keeping the current kernel, if this CPU or build does not have it.
+         */
+        static bool useKernel(const char *name);
+
+    private:
+        friend void sealBatch(const AeadMessage *messages, size_t count);
+        friend size_t openBatch(const AeadMessage *messages, size_t count, bool *authentic);
+
+        uint32_t keyWords[8]{};
+    };
+
+    /**
+     * @brief Seals several messages, sharing the vector lanes between them.
+     * @param messages The messages, each with its cipher, nonce and tag.
+     * @param count The number of messages.
+     */
+    void sealBatch(const AeadMessage *messages, size_t count);
+
+    /**
+     * @brief Opens several messages like ChaCha20Poly1305::open(), sharing the vector lanes between them.
+     * @param messages The messages, each with its cipher, nonce and tag.
+     * @param count The number of messages.
+     * @param authentic Receives, per message, whether it was authentic and is now decrypted.
+     * @return The number of authentic messages.
+     */
+    size_t openBatch(const AeadMessage *messages, size_t count, bool *authentic);
+}
+
+#endif //CHACHA20POLY1305_H
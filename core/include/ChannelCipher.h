@@ -0,0 +1,138 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef CHANNELCIPHER_H
+#define CHANNELCIPHER_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "ChaCha20Poly1305.h"
+#include "Mutex.h"
+#include "Packet.h"
+#include "ReplayWindow.h"
+
+namespace YunaProtocol {
+
+    /**
+     * @brief Counters of a node's channel encryption.
+     */
+    struct EncryptionStats {
+        uint64_t sealed = 0; // DATA packets encrypted before sending.
+        uint64_t opened = 0; // Packets authenticated and decrypted.
+        uint64_t authenticationFailures = 0; // Forged, altered or sealed under another key.
+        uint64_t replays = 0; // Authentic packets received before, or too old to tell.
+        uint64_t unknownChannel = 0; // Encrypted on a channel this node has no key for.
+        uint64_t plaintextRejected = 0; // Unencrypted data on a channel that has a key.
+        uint64_t noSession = 0; // Not sent: no fresh nonce session was available yet.
+    };
+
+    /**
+     * @class ChannelCipher
+     * @brief Per-channel authenticated encryption of DATA packets with ChaCha20-Poly1305.
+     *
+     * Every node on a channel shares its 32-byte key. The packet header is authenticated as
+     * additional data, so the channel, source, sequence and flags cannot be altered either; only
+     * the payload is encrypted, followed by its tag. The 96-bit nonce is the source ID and the
+     * header's 64-bit nonce field: a session, then a counter. Received nonces go through a
+     * ReplayWindow once the tag verified, which rejects sessions older than the latest one.
+     *
+     * A session must never repeat under a key, or nonces would be reused. With YUNA_CLOCK_SESSIONS
+     * it is the Unix time in seconds, taken once the clock has left the second the cipher was
+     * created in, so two runs never share one; a clock before 2025 is taken as unset and never
+     * used. Otherwise, and whenever the clock may step backwards across restarts, the application
+     * passes a counter kept in persistent storage to setSession(). Until a session is known to be
+     * fresh, packets on keyed channels are not sealed and must not be sent.
+     *
+     * Keys may be changed from any thread; lookups copy the key out under a short lock. seal()
+     * may run on any thread, open() and acceptPlaintext() on one receiving thread at a time.
+     */
+    class ChannelCipher {
+    public:
+        ChannelCipher();
+
+        /**
+         * @brief Sets the key of a channel, replacing the previous one.
+         * @param channel The channel name, matched exactly.
+         * @param key AEAD_KEY_SIZE bytes.
+         */
+        void setKey(const std::string& channel, const uint8_t *key);
+
+        /**
+         * @return False if the channel had no key.
+         */
+        bool clearKey(const std::string& channel);
+
+        bool hasKey(const std::string& channel) const;
+
+        /**
+         * @brief Sets the session, e.g. a boot counter from persistent storage.
+         *
+         * It must be higher than every session used before under the same keys: a repeated one
+         * reuses nonces, a lower one is rejected by peers as a replay. Call it before the first
+         * packet is sealed.
+         */
+        void setSession(uint32_t session);
+
+        /**
+         * @brief The channels that have a key.
+         */
+        std::vector<std::string> channels() const;
+
+        /**
+         * @brief Seals the DATA packets of keyed channels, all in one batch; other packets are left alone.
+         *
+         * Sets PACKET_FLAG_ENCRYPTED and the nonce, and appends the tag to the payload. The header
+         * must be final: anything changed afterwards fails authentication.
+         * @return False, counted, if packets needed sealing but no fresh session is available yet;
+         * they are left unsealed and the caller must drop them (see needsSealing()).
+         */
+        bool seal(Packet *packets, size_t count);
+
+        /**
+         * @brief Tells whether a packet is sent encrypted but is not sealed yet.
+         */
+        bool needsSealing(const Packet& packet) const;
+
+        /**
+         * @brief Authenticates and decrypts an encrypted packet.
+         * @param packet A packet carrying PACKET_FLAG_ENCRYPTED.
+         * @param plain Receives the packet with its plaintext payload, the flag still set.
+         * @return False if the channel has no key, or the packet is not authentic or a replay.
+         */
+        bool open(const Packet& packet, Packet& plain);
+
+        /**
+         * @brief Tells whether an unencrypted DATA payload may be accepted on a channel.
+         * @return False, counted, if the channel has a key.
+         */
+        bool acceptPlaintext(std::string_view channel);
+
+        EncryptionStats getStats() const;
+
+    private:
+        mutable Mutex keyMutex; // Guards keys.
+        std::unordered_map<std::string, ChaCha20Poly1305> keys;
+        std::atomic<size_t> keyCount{0}; // Read without the lock, so nodes without keys never take it.
+        bool freshSession(); // Picks a clock session once it is safe; keyMutex held.
+
+        std::atomic<uint64_t> nextNonce{0};
+        std::atomic<bool> sessionReady{false};
+        uint32_t createdSecond; // The clock when the cipher was created; the session must be later.
+        ReplayWindow replayWindow;
+        std::atomic<uint64_t> sealed{0};
+        std::atomic<uint64_t> opened{0};
+        std::atomic<uint64_t> authenticationFailures{0};
+        std::atomic<uint64_t> replays{0};
+        std::atomic<uint64_t> unknownChannel{0};
+        std::atomic<uint64_t> plaintextRejected{0};
+        std::atomic<uint64_t> noSession{0};
+    };
+}
+
+#endif //CHANNELCIPHER_H
@@ -0,0 +1,132 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef CHANNELTRIE_H
+#define CHANNELTRIE_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace YunaProtocol {
+
+    /**
+     * @class ChannelTrie
+     * @brief Matches hierarchical channel names against subscription filters.
+     *
+     * Channel names are split into levels by '/', e.g. "sensors/floor3/temp". A filter level
+     * of "+" matches exactly one level of any name, and a last level of "#" matches the
+     * remaining levels, none included: "sensors/#" matches "sensors" and "sensors/floor3/temp".
+     * Filters are stored level by level in a prefix tree built when they are inserted, so
+     * matching a channel costs one lookup per level and per matching "+" branch, however many
+     * filters are registered. Each filter maps to a subscription number chosen by the caller.
+     */
+    class ChannelTrie {
+    public:
+        static constexpr uint32_t NO_SUBSCRIPTION = UINT32_MAX;
+
+        /**
+         * @brief Whether a filter is well formed: "+" and "#" fill a whole level and "#" is the last one.
+         */
+        static bool isValidFilter(std::string_view filter);
+
+        /**
+         * @brief Matches a single channel name against a single filter, without building a tree.
+         * @param filter A valid filter.
+         * @param channel The channel name.
+         */
+        static bool matches(std::string_view filter, std::string_view channel);
+
+        /**
+         * @brief Adds a filter, or changes its subscription if it is already present.
+         * @param filter The filter.
+         * @param subscription The number matching channels report. Must not be NO_SUBSCRIPTION.
+         * @return False if the filter is not valid.
+         */
+        bool insert(std::string_view filter, uint32_t subscription);
+
+        /**
+         * @brief Looks up the subscription of a filter, compared literally.
+         * @return The subscription, or NO_SUBSCRIPTION if the filter is not present.
+         */
+        uint32_t find(std::string_view filter) const;
+
+        /**
+         * @brief Removes a filter.
+         * @return The subscription it had, or NO_SUBSCRIPTION if it was not present.
+         */
+        uint32_t erase(std::string_view filter);
+
+        /**
+         * @brief Number of filters present.
+         */
+        size_t size() const;
+
+        /**
+         * @brief Calls a visitor with the subscription of every filter matching a channel name.
+         *
+         * Each matching filter is visited once, in no particular order. The visitor may insert
+         * filters; whether they match the channel being visited is unspecified.
+         * @param channel The channel name.
+         * @param visit Any callable taking a uint32_t subscription.
+         */
+        template <typename Visitor>
+        void forEachMatch(std::string_view channel, Visitor&& visit) const {
+            matchLevel(0, channel.data(), channel.data() + channel.size(), true, visit);
+        }
+
+    private:
+        static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+        struct Node {
+            std::vector<std::pair<std::string, uint32_t> > children; // Literal levels, sorted by name.
+            uint32_t anyLevel = NO_NODE; // The "+" child.
+            uint32_t subscription = NO_SUBSCRIPTION; // Filter ending at this level.
+            uint32_t remainingLevels = NO_SUBSCRIPTION; // Filter ending with "#" below this level.
+        };
+
+        uint32_t childOf(uint32_t node, std::string_view level) const;
+
+        uint32_t addChild(uint32_t node, std::string_view level);
+
+        // Finds the node a filter ends at, and whether it ends with "#" below it.
+        bool locate(std::string_view filter, uint32_t& node, bool& remaining) const;
+
+        // Only node indices are held across visits, as a visitor inserting filters may grow the nodes.
+        template <typename Visitor>
+        void matchLevel(uint32_t node, const char *level, const char *end, bool hasLevel, Visitor& visit) const {
+            if (nodes[node].remainingLevels != NO_SUBSCRIPTION) {
+                visit(nodes[node].remainingLevels);
+            }
+            if (!hasLevel) {
+                if (nodes[node].subscription != NO_SUBSCRIPTION) {
+                    visit(nodes[node].subscription);
+                }
+                return;
+            }
+            const char *separator = level;
+            while (separator != end && *separator != '/') {
+                separator++;
+            }
+            bool hasNext = separator != end;
+            const char *next = hasNext ? separator + 1 : end;
+
+            uint32_t literal = childOf(node, std::string_view(level, static_cast<size_t>(separator - level)));
+            if (literal != NO_NODE) {
+                matchLevel(literal, next, end, hasNext, visit);
+            }
+            uint32_t any = nodes[node].anyLevel;
+            if (any != NO_NODE) {
+                matchLevel(any, next, end, hasNext, visit);
+            }
+        }
+
+        std::vector<Node> nodes = std::vector<Node>(1); // nodes[0] is the root, above the first level.
+        size_t filters = 0;
+    };
+}
+
+#endif //CHANNELTRIE_H
@@ -0,0 +1,34 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+#include <cstddef>
+#include <cstdint>
+
+namespace YunaProtocol {
+    /**
+     * @brief Computes the CRC32C (Castagnoli) checksum of a buffer.
+     *
+     * Uses the SSE4.2 or ARMv8 CRC instructions when the CPU has them and a
+     * table-driven implementation otherwise (e.g. on the ESP8266).
+     * @param data The bytes to checksum.
+     * @param length The number of bytes.
+     * @param previous The checksum of the preceding bytes, to checksum a buffer in pieces.
+     * @return The checksum.
+     */
+    uint32_t crc32c(const uint8_t *data, size_t length, uint32_t previous = 0);
+
+    /**
+     * @brief Reports whether crc32c() runs on dedicated CPU instructions.
+     */
+    bool crc32cIsHardwareAccelerated();
+
+    /**
+     * @brief The table-driven crc32c(), whatever the CPU, e.g. to compare it with the hardware one.
+     */
+    uint32_t crc32cTable(const uint8_t *data, size_t length, uint32_t previous = 0);
+}
+
+#endif //CHECKSUM_H
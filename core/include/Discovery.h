@@ -0,0 +1,87 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef DISCOVERY_H
+#define DISCOVERY_H
+#include <cstddef>
+#include <cstdint>
+
+namespace YunaProtocol {
+
+    // Size of one DISCOVERY_REPLY peer list entry: client ID, IPv4 address and UDP port.
+    constexpr size_t PEER_ENTRY_SIZE = 10;
+
+    // Most peers one DISCOVERY_REPLY lists, which keeps it within a single unfragmented datagram.
+    constexpr size_t MAX_PEERS_PER_REPLY = 128;
+
+    /**
+     * @brief Where a peer can be reached, as listed in a DISCOVERY_REPLY.
+     */
+    struct PeerAddress {
+        uint32_t clientId = 0;
+        uint32_t ipv4 = 0; // Host byte order, e.g. 0x0A000001 for 10.0.0.1.
+        uint16_t port = 0;
+    };
+
+    /**
+     * @brief Writes a peer list entry: the client ID little-endian like the header, then address and port big-endian.
+     * @param peer The peer to write.
+     * @param entry Destination of PEER_ENTRY_SIZE bytes.
+     */
+    void writePeerEntry(const PeerAddress &peer, uint8_t *entry);
+
+    /**
+     * @brief Reads a peer list entry written by writePeerEntry().
+     * @param entry PEER_ENTRY_SIZE bytes.
+     */
+    PeerAddress readPeerEntry(const uint8_t *entry);
+
+    /**
+     * @class JoinSchedule
+     * @brief Timing of the discovery burst a transport sends when it starts.
+     *
+     * The first join is due at once, then each retry waits twice as long as the previous one,
+     * randomly stretched or shortened by up to half so nodes restarted together do not stay in
+     * step. The burst ends after the last attempt or as soon as a peer replies.
+     */
+    class JoinSchedule {
+    public:
+        /**
+         * @param attempts Number of joins sent, including the first one.
+         * @param firstRetryMs Mean delay before the first retry.
+         */
+        explicit JoinSchedule(uint8_t attempts = 4, uint32_t firstRetryMs = 50);
+
+        /**
+         * @brief Starts a burst whose first join is due immediately.
+         * @param nowMs The current time, from any millisecond clock that may wrap around.
+         * @param seed Varies the jitter between nodes, e.g. the node ID mixed with the time.
+         */
+        void start(uint32_t nowMs, uint32_t seed);
+
+        /**
+         * @brief Tells whether a join should be sent now, and if so schedules the next one.
+         */
+        bool due(uint32_t nowMs);
+
+        /**
+         * @brief Ends the burst: a peer answered with the peers it knows.
+         */
+        void onReply();
+
+        bool active() const;
+
+    private:
+        uint32_t nextRandom();
+
+        uint8_t attempts;
+        uint8_t remaining = 0;
+        uint32_t firstRetryMs;
+        uint32_t delayMs = 0;
+        uint32_t nextAtMs = 0;
+        uint32_t randomState = 1;
+    };
+}
+
+#endif //DISCOVERY_H
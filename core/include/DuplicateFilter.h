@@ -0,0 +1,71 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef DUPLICATEFILTER_H
+#define DUPLICATEFILTER_H
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+
+namespace YunaProtocol {
+
+    /**
+     * @class DuplicateFilter
+     * @brief Sliding-window duplicate detection over per-source sequence numbers.
+     *
+     * Each source keeps the highest sequence number seen and a 64-bit bitmap of the
+     * sequence numbers just below it. Sequence numbers compare with wrap-around, and 0
+     * means "unsequenced" and is always accepted. A packet behind the window but within
+     * STALE_BAND of it is too late to tell apart from a duplicate, e.g. a copy that took a
+     * slower path, and is dropped. Only a sequence number further behind is taken as the
+     * source restarting its counter, and resets the window. Sources start their counter at
+     * a random value, so after a restart it almost never lands in the window or the band.
+     *
+     * accept() and forget() are not thread-safe; duplicates() may be read from any thread.
+     */
+    class DuplicateFilter {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr uint32_t WINDOW_SIZE = 64;
+        // How far behind the window packets are dropped as late rather than taken as a restart.
+        static constexpr uint32_t STALE_BAND = 1u << 16;
+
+        /**
+         * @brief Records a packet and tells whether it was seen before.
+         * @param sourceId The sending node.
+         * @param sequence The packet's sequence number.
+         * @return True for a new packet, false for a duplicate.
+         */
+        bool accept(uint32_t sourceId, uint32_t sequence);
+
+        /**
+         * @brief Drops the window of a source, e.g. when it leaves.
+         */
+        void forget(uint32_t sourceId);
+
+        /**
+         * @brief Drops the windows of sources not heard from since a point in time.
+         */
+        void prune(Clock::time_point idleSince);
+
+        /**
+         * @brief Number of duplicates and late packets rejected so far.
+         */
+        uint64_t duplicates() const;
+
+    private:
+        struct Window {
+            uint32_t highest = 0;
+            uint64_t bitmap = 0; // Bit n set: highest - n was seen.
+            Clock::time_point lastSeen;
+        };
+
+        std::unordered_map<uint32_t, Window> windows;
+        std::atomic<uint64_t> rejected{0};
+    };
+}
+
+#endif //DUPLICATEFILTER_H
@@ -0,0 +1,105 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef EPOCHDOMAIN_H
+#define EPOCHDOMAIN_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace YunaProtocol {
+
+    /**
+     * @class EpochDomain
+     * @brief Epoch-based reclamation for data that is read without locks and replaced copy-on-write.
+     *
+     * Readers announce themselves on one of two counters, picked by the parity of a global
+     * epoch, for as long as they use the shared data; this is two atomic increments and never
+     * waits. A writer swaps in a new version and retires the old one, tagged with the current
+     * epoch. The epoch only advances once the counter of the previous epoch has drained, so an
+     * object retired in epoch k can no longer be seen by any reader once the epoch reaches k + 2.
+     * Nothing ever waits for readers: objects still in use are freed by a later reclaim().
+     *
+     * Readers may nest and may run on any thread. retire() and reclaim() must be serialized by the caller.
+     */
+    class EpochDomain {
+    public:
+        /**
+         * @brief Read-side critical section, for the lifetime of the guard.
+         */
+        class ReadGuard {
+        public:
+            explicit ReadGuard(EpochDomain& domain) : domain(domain), slot(domain.enter()) {}
+
+            ~ReadGuard() {
+                domain.exit(slot);
+            }
+
+            ReadGuard(const ReadGuard&) = delete;
+            ReadGuard& operator=(const ReadGuard&) = delete;
+
+        private:
+            EpochDomain& domain;
+            uint32_t slot;
+        };
+
+        EpochDomain() = default;
+
+        /**
+         * @brief Frees every object still retired. No reader may be left.
+         */
+        ~EpochDomain();
+
+        EpochDomain(const EpochDomain&) = delete;
+        EpochDomain& operator=(const EpochDomain&) = delete;
+
+        /**
+         * @brief Hands over an object readers can no longer reach, to be deleted once none of them uses it.
+         * @param object The object, already replaced in the shared data.
+         */
+        template <typename T>
+        void retire(const T *object) {
+            retire(const_cast<T *>(object), [](void *retiredObject) { delete static_cast<T *>(retiredObject); });
+        }
+
+        /**
+         * @brief Advances the epoch where possible and deletes the objects no reader can see anymore.
+         */
+        void reclaim();
+
+        /**
+         * @brief Number of retired objects not deleted yet. Safe to call from any thread.
+         */
+        size_t pending() const;
+
+    private:
+        struct Retired {
+            void *object;
+            void (*deleter)(void *);
+            uint32_t epoch;
+        };
+
+        uint32_t enter() {
+            uint32_t slot = epoch.load() & 1;
+            readers[slot].fetch_add(1);
+            return slot;
+        }
+
+        void exit(uint32_t slot) {
+            readers[slot].fetch_sub(1);
+        }
+
+        void retire(void *object, void (*deleter)(void *));
+
+        void tryAdvance();
+
+        std::atomic<uint32_t> epoch{0};
+        std::atomic<uint32_t> readers[2]{};
+        std::vector<Retired> retired;
+        std::atomic<size_t> retiredCount{0};
+    };
+}
+
+#endif //EPOCHDOMAIN_H
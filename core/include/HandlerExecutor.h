@@ -0,0 +1,238 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef HANDLEREXECUTOR_H
+#define HANDLEREXECUTOR_H
+#include "YunaConfig.h"
+
+#if YUNA_HAS_THREADS
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace YunaProtocol {
+
+    /**
+     * @class InplaceTask
+     * @brief Move-only, zero-argument callable stored inline.
+     *
+     * Unlike std::function it never allocates and is not copyable: the callable must fit
+     * into Capacity bytes, which is checked at compile time.
+     */
+    template<size_t Capacity>
+    class InplaceTask {
+        struct Ops {
+            void (*invoke)(void *self);
+            void (*relocate)(void *dst, void *src); // Move-constructs into dst, then destroys src.
+            void (*destroy)(void *self);
+        };
+
+        template<class Fn>
+        static const Ops *opsFor() {
+            static const Ops ops{
+                [](void *self) { (*static_cast<Fn *>(self))(); },
+                [](void *dst, void *src) {
+                    new(dst) Fn(std::move(*static_cast<Fn *>(src)));
+                    static_cast<Fn *>(src)->~Fn();
+                },
+                [](void *self) { static_cast<Fn *>(self)->~Fn(); }
+            };
+            return &ops;
+        }
+
+        alignas(std::max_align_t) unsigned char storage[Capacity]{};
+        const Ops *ops = nullptr;
+
+    public:
+        InplaceTask() = default;
+
+        template<class F, class = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InplaceTask> > >
+        InplaceTask(F &&f) { // NOLINT(google-explicit-constructor)
+            using Fn = std::decay_t<F>;
+            static_assert(sizeof(Fn) <= Capacity, "Callable does not fit into InplaceTask storage");
+            static_assert(alignof(Fn) <= alignof(std::max_align_t), "Callable is over-aligned");
+            new(storage) Fn(std::forward<F>(f));
+            ops = opsFor<Fn>();
+        }
+
+        InplaceTask(InplaceTask &&other) noexcept {
+            if (other.ops) {
+                other.ops->relocate(storage, other.storage);
+                ops = other.ops;
+                other.ops = nullptr;
+            }
+        }
+
+        InplaceTask &operator=(InplaceTask &&other) noexcept {
+            if (this != &other) {
+                reset();
+                if (other.ops) {
+                    other.ops->relocate(storage, other.storage);
+                    ops = other.ops;
+                    other.ops = nullptr;
+                }
+            }
+            return *this;
+        }
+
+        InplaceTask(const InplaceTask &) = delete;
+        InplaceTask &operator=(const InplaceTask &) = delete;
+
+        ~InplaceTask() { reset(); }
+
+        void reset() {
+            if (ops) {
+                ops->destroy(storage);
+                ops = nullptr;
+            }
+        }
+
+        explicit operator bool() const { return ops != nullptr; }
+
+        void operator()() { ops->invoke(storage); }
+    };
+
+    /**
+     * @brief Selects which packet field keeps handler invocations in order.
+     */
+    enum class OrderingKey {
+        Channel, // Packets on the same channel run in arrival order.
+        Source, // Packets from the same source node run in arrival order.
+    };
+
+    /**
+     * @brief Snapshot of the executor counters. Times are in nanoseconds.
+     */
+    struct ExecutorStats {
+        uint64_t submitted = 0;
+        uint64_t executed = 0;
+        uint64_t steals = 0;
+        size_t queueDepth = 0;
+        size_t maxQueueDepth = 0;
+        uint64_t totalQueueDelayNs = 0; // Time between submit() and the handler starting.
+        uint64_t maxQueueDelayNs = 0;
+        uint64_t totalHandlerNs = 0; // Time spent inside handlers.
+        uint64_t maxHandlerNs = 0;
+    };
+
+    /**
+     * @class HandlerExecutor
+     * @brief Work-stealing thread pool that runs packet handlers off the loop() thread.
+     *
+     * Every submitted task carries an ordering key which is hashed onto a strand. A strand
+     * runs its tasks strictly in submission order and on at most one worker at a time, so
+     * handlers for the same key never overlap or reorder while different keys run in
+     * parallel. Ready strands sit in their home worker's run queue; idle workers steal from
+     * the back of other workers' queues. A strand yields after YUNA_HANDLER_STRAND_BATCH tasks
+     * so a busy channel cannot starve the others sharing its worker.
+     *
+     * Keys that hash onto the same strand are still serialized: a slow handler delays every key
+     * behind it. Keys that must never wait for another key, e.g. a control channel next to an
+     * image processing one, are given a dedicated strand at construction.
+     */
+    class HandlerExecutor {
+    public:
+        using Task = InplaceTask<YUNA_HANDLER_TASK_CAPACITY>;
+
+        /**
+         * @brief Starts the worker threads.
+         * @param threadCount Number of workers, at least one.
+         * @param strandCount Number of ordering strands keys are hashed onto.
+         * @param dedicatedKeys Keys with a strand of their own, shared with no other key.
+         */
+        explicit HandlerExecutor(size_t threadCount, size_t strandCount = 64,
+                                 std::vector<uint32_t> dedicatedKeys = {});
+
+        /**
+         * @brief Runs every queued task, then joins the workers.
+         */
+        ~HandlerExecutor();
+
+        HandlerExecutor(const HandlerExecutor &) = delete;
+        HandlerExecutor &operator=(const HandlerExecutor &) = delete;
+
+        /**
+         * @brief Queues a task behind every earlier task submitted with the same key.
+         * @param key The ordering key, e.g. a channel hash or a source node ID.
+         * @param task The work to run.
+         */
+        void submit(uint32_t key, Task task);
+
+        /**
+         * @brief Number of tasks submitted but not yet started.
+         */
+        size_t queueDepth() const;
+
+        ExecutorStats getStats() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Item {
+            Task task;
+            Clock::time_point enqueuedAt;
+        };
+
+        struct Strand {
+            std::mutex mutex;
+            std::deque<Item> pending;
+            bool scheduled = false; // True while the strand sits in a run queue or is running.
+            size_t homeWorker = 0;
+        };
+
+        struct Worker {
+            std::mutex mutex;
+            std::deque<Strand *> runQueue;
+            std::thread thread;
+        };
+
+        Strand *strandFor(uint32_t key) const;
+
+        void workerLoop(size_t index);
+
+        void schedule(Strand *strand, size_t workerIndex);
+
+        Strand *popLocal(size_t index);
+
+        Strand *steal(size_t index);
+
+        void runStrand(Strand *strand, size_t workerIndex);
+
+        static void updateMax(std::atomic<uint64_t> &target, uint64_t value);
+
+        std::vector<std::unique_ptr<Strand> > strands; // Hashed strands, then one per dedicated key.
+        size_t hashedStrands = 0;
+        std::vector<uint32_t> dedicatedKeys; // Sorted; never changes after construction, so read without a lock.
+        std::vector<std::unique_ptr<Worker> > workers;
+
+        std::mutex sleepMutex;
+        std::condition_variable wakeUp;
+        std::atomic<size_t> readyStrands{0};
+        std::atomic<bool> stopping{false};
+
+        std::atomic<size_t> depth{0};
+        std::atomic<uint64_t> maxDepth{0};
+        std::atomic<uint64_t> submitted{0};
+        std::atomic<uint64_t> executed{0};
+        std::atomic<uint64_t> steals{0};
+        std::atomic<uint64_t> totalQueueDelayNs{0};
+        std::atomic<uint64_t> maxQueueDelayNs{0};
+        std::atomic<uint64_t> totalHandlerNs{0};
+        std::atomic<uint64_t> maxHandlerNs{0};
+    };
+}
+
+#endif // YUNA_HAS_THREADS
+
+#endif //HANDLEREXECUTOR_H
@@ -0,0 +1,64 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace YunaProtocol {
+
+    /**
+     * @brief Current wall clock time in nanoseconds since the Unix epoch.
+     *
+     * This is the clock (CLOCK_REALTIME) kernel software receive timestamps use, so both can be compared.
+     */
+    uint64_t wallClockNs();
+
+    /**
+     * @brief Copy of a LatencyHistogram. Percentiles are bucket upper bounds, in nanoseconds.
+     */
+    struct HistogramSnapshot {
+        static constexpr size_t BUCKETS = 40;
+
+        uint64_t count = 0;
+        uint64_t p50Ns = 0;
+        uint64_t p90Ns = 0;
+        uint64_t p99Ns = 0;
+        uint64_t maxNs = 0;
+        std::array<uint32_t, BUCKETS> buckets{}; // Bucket i counts samples in [2^i, 2^(i+1)) ns.
+    };
+
+    /**
+     * @class LatencyHistogram
+     * @brief Lock-free log2 histogram of durations in nanoseconds.
+     *
+     * Recording is a couple of relaxed atomic increments, so it can be fed from the loop()
+     * thread and from handler executor workers at the same time.
+     */
+    class LatencyHistogram {
+    public:
+        void record(uint64_t nanoseconds);
+
+        HistogramSnapshot snapshot() const;
+
+        void reset();
+
+    private:
+        std::array<std::atomic<uint32_t>, HistogramSnapshot::BUCKETS> buckets{};
+    };
+
+    /**
+     * @brief Where received packets spend their time, one histogram per stage.
+     */
+    struct LatencyStats {
+        HistogramSnapshot kernelToDecode; // Kernel receive timestamp to decode: socket buffer plus loop() backlog.
+        HistogramSnapshot decodeToHandler; // Decode to handler start: node processing plus executor queue.
+        HistogramSnapshot handler; // Time spent inside the handler.
+    };
+}
+
+#endif //LATENCYHISTOGRAM_H
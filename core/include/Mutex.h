@@ -0,0 +1,31 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef MUTEX_H
+#define MUTEX_H
+#include "YunaConfig.h"
+
+#if YUNA_HAS_THREADS
+#include <mutex>
+#endif
+
+namespace YunaProtocol {
+
+#if YUNA_HAS_THREADS
+    using Mutex = std::mutex;
+    using LockGuard = std::lock_guard<std::mutex>;
+#else
+    // Without threads there is nothing to exclude, so locking compiles to nothing.
+    struct Mutex {
+        void lock() {}
+        void unlock() {}
+    };
+
+    struct LockGuard {
+        explicit LockGuard(Mutex&) {}
+    };
+#endif
+}
+
+#endif //MUTEX_H
@@ -4,33 +4,102 @@
 
 #ifndef PACKET_H
 #define PACKET_H
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
 
 namespace YunaProtocol {
+    struct PacketView;
+
+    // Bumped whenever the PacketHeader layout changes; packets of other versions are rejected.
+    constexpr uint8_t PROTOCOL_VERSION = 4;
+
     enum PacketType {
         DISCOVERY_PEER = 0x01, // Discovery packet to find peers
         DATA = 0x02, // Data packet for communication
         ACKNOWLEDGEMENT = 0x03, // Acknowledgement packet: for confirming receipt of data
         PING = 0x04, // Ping packet for latency checks
+        RETAINED_SYNC = 0x05, // Batch of retained channel values sent to a newly discovered peer
+        DISCOVERY_REPLY = 0x06, // Unicast answer to a joining node, listing the peers the sender knows
+    };
+
+    /**
+     * @brief Scheduling class of outgoing packets, from most to least urgent.
+     */
+    enum class PriorityClass : uint8_t {
+        Control = 0, // Protocol traffic: probes, acknowledgements, retained syncs. Always served first.
+        Interactive = 1, // Latency-critical data, e.g. actuator commands.
+        Standard = 2, // Default for data channels.
+        Bulk = 3, // Throughput traffic such as log uploads.
+    };
+
+    constexpr size_t PRIORITY_CLASS_COUNT = 4;
+
+    /**
+     * @brief DSCP code point a priority class is marked with: CS6, EF, default forwarding and CS1.
+     */
+    constexpr uint8_t dscpForPriority(PriorityClass priority) {
+        return priority == PriorityClass::Control ? 48
+             : priority == PriorityClass::Interactive ? 46
+             : priority == PriorityClass::Bulk ? 8
+             : 0;
+    }
+
+    /**
+     * @brief Linux SO_PRIORITY a priority class is mapped to (0 to 6 need no privileges).
+     */
+    constexpr int socketPriorityFor(PriorityClass priority) {
+        return priority == PriorityClass::Control ? 6
+             : priority == PriorityClass::Interactive ? 5
+             : priority == PriorityClass::Bulk ? 1
+             : 0;
+    }
+
+    enum PacketFlags {
+        PACKET_FLAG_CRC32C = 0x01, // A CRC32C of header and payload follows the payload
+        PACKET_FLAG_RETAINED = 0x02, // Receivers keep the payload as the channel's last value
+        PACKET_FLAG_JOIN = 0x04, // DISCOVERY_PEER sent by a starting node: peers answer with a DISCOVERY_REPLY
+        PACKET_FLAG_ENCRYPTED = 0x08, // The payload is ChaCha20-Poly1305 ciphertext followed by its 16-byte tag
+    };
+
+    // Size of the integrity trailer appended when PACKET_FLAG_CRC32C is set.
+    constexpr size_t PACKET_CHECKSUM_SIZE = 4;
+
+    enum class DecodeStatus {
+        Ok,
+        Truncated, // The buffer is shorter than the header, payload or trailer it announces.
+        UnsupportedVersion, // The sender speaks another protocol version.
+        ChecksumMismatch, // The CRC32C trailer does not match: the datagram was corrupted.
     };
 
 #pragma pack(push, 1) // Ensure struct is packed without padding
     struct PacketHeader {
-        uint8_t protocolVersion = 1;
+        uint8_t protocolVersion = PROTOCOL_VERSION;
         PacketType packetType = PING;
         uint32_t sourceId{};
         char channel[32]{};
-        uint64_t channelPassword = 0;
+        uint64_t nonce = 0; // Sender's AEAD nonce (session, counter) when PACKET_FLAG_ENCRYPTED is set
         uint16_t payloadLength{};
+        uint8_t flags = 0; // Combination of PacketFlags
+        uint32_t sequence = 0; // Per-source packet counter used to drop duplicates, 0 if unsequenced
 
     };
 #pragma pack(pop)
 
+    /**
+     * @brief Receive-side timestamps of a packet, in nanoseconds since the Unix epoch. Not serialized; 0 when unknown.
+     */
+    struct PacketTimestamps {
+        uint64_t kernelRxNs = 0; // Software receive timestamp taken by the kernel (SO_TIMESTAMPING).
+        uint64_t hardwareRxNs = 0; // Raw NIC timestamp, in the NIC's clock domain.
+        uint64_t decodedNs = 0; // Decode time, set by transports that take kernel timestamps; otherwise 0.
+    };
+
     struct Packet {
         PacketHeader header;
         std::vector<uint8_t> payload;
+        PacketTimestamps timestamps;
         /**
     * @brief Serializes the entire packet (header + payload) into a byte buffer.
     * @param buffer The vector to store the serialized data.
@@ -46,6 +115,64 @@ namespace YunaProtocol {
  * @return True if deserialization is successful.
  */
         bool deserialize(const uint8_t *buffer, size_t size);
+
+        /**
+ * @brief Deserializes a byte buffer like deserialize(), reporting why it was rejected.
+ *
+ * When the header carries PACKET_FLAG_CRC32C the trailer is verified before the payload is copied.
+ * @param buffer The byte buffer to deserialize.
+ * @param size The size of the buffer.
+ * @return DecodeStatus::Ok if the packet is valid.
+ */
+        DecodeStatus decode(const uint8_t *buffer, size_t size);
+
+        /**
+ * @brief A view of this packet, with header.payloadLength set to the payload size.
+ */
+        PacketView view() const;
+    };
+
+    /**
+     * @brief A decoded packet whose payload still points into the receive buffer.
+     *
+     * Lets a transport hand out packets without copying them. It is only valid as long as the
+     * buffer it was decoded from; toPacket() makes an owning copy.
+     */
+    struct PacketView {
+        PacketHeader header;
+        const uint8_t *payload = nullptr; // header.payloadLength bytes.
+        PacketTimestamps timestamps;
+
+        /**
+         * @brief Validates a byte buffer like Packet::decode() and points the view into it.
+         * @param buffer The byte buffer to decode, which must outlive the view.
+         * @param size The size of the buffer.
+         * @return DecodeStatus::Ok if the packet is valid.
+         */
+        DecodeStatus decode(const uint8_t *buffer, size_t size);
+
+        /**
+         * @brief Number of bytes serialize() writes: header, payload and the optional CRC32C trailer.
+         */
+        size_t serializedSize() const;
+
+        /**
+         * @brief Serializes the packet into a caller-provided buffer, without allocating.
+         * @param buffer The destination.
+         * @param capacity The size of the destination.
+         * @return The number of bytes written, or 0 if the buffer is too small.
+         */
+        size_t serialize(uint8_t *buffer, size_t capacity) const;
+
+        /**
+         * @brief The CRC32C trailer of the header and payload, computed without copying them together.
+         */
+        uint32_t checksum() const;
+
+        /**
+         * @brief Copies the viewed packet into an owning Packet.
+         */
+        Packet toPacket() const;
     };
 }
 
@@ -0,0 +1,168 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef PACKETCAPTURE_H
+#define PACKETCAPTURE_H
+#include "YunaConfig.h"
+
+#if YUNA_HAS_MMAP
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "Transport.h"
+
+namespace YunaProtocol {
+
+#pragma pack(push, 1)
+    /**
+     * @brief Header at the start of every capture segment file.
+     */
+    struct CaptureFileHeader {
+        char magic[4] = {'Y', 'C', 'A', 'P'};
+        uint16_t version = 1;
+        uint16_t reserved = 0;
+        uint32_t segmentIndex = 0;
+        uint32_t captureId = 0; // Shared by the segments of one capture, so leftovers of another are not read.
+        uint64_t createdNs = 0; // Wall clock, nanoseconds since the Unix epoch.
+    };
+
+    /**
+     * @brief Header in front of every captured frame. Records are padded to 8 bytes; a zeroed
+     * header marks the end of a segment that was not closed cleanly.
+     */
+    struct CaptureRecordHeader {
+        uint64_t timestampNs = 0; // Wall clock, nanoseconds since the Unix epoch.
+        uint32_t length = 0;
+        uint8_t direction = 0; // A FrameDirection value.
+        uint8_t reserved[3]{};
+    };
+#pragma pack(pop)
+
+    /**
+     * @class CaptureWriter
+     * @brief FrameTap that appends every frame with a timestamp to memory-mapped log segments.
+     *
+     * Segments are named "<basePath>.<index>.ycap" and preallocated to their full size, so
+     * appending a frame is a memcpy into the mapping. When a frame does not fit, the segment
+     * is trimmed to its used size and the next one is started. With a segment limit the
+     * oldest segments are deleted, turning the capture into a ring.
+     */
+    class CaptureWriter : public FrameTap {
+    public:
+        /**
+         * @param basePath Path prefix of the segment files.
+         * @param segmentSize Size of one segment file in bytes.
+         * @param maxSegments Number of segments kept on disk, or 0 to keep all of them.
+         */
+        explicit CaptureWriter(std::string basePath, size_t segmentSize = 64 * 1024 * 1024, size_t maxSegments = 0);
+
+        ~CaptureWriter() override;
+
+        CaptureWriter(const CaptureWriter &) = delete;
+        CaptureWriter &operator=(const CaptureWriter &) = delete;
+
+        /**
+         * @brief Deletes the segments of any previous capture at this path and creates the first one.
+         *
+         * Must be called before frames are captured.
+         * @return True if the segment file could be created and mapped.
+         */
+        bool open();
+
+        /**
+         * @brief Trims and closes the current segment.
+         */
+        void close();
+
+        void onFrame(FrameDirection direction, const uint8_t *data, size_t size) override;
+
+        /**
+         * @brief Number of frames written so far.
+         */
+        uint64_t capturedFrames() const;
+
+        /**
+         * @brief Number of frames dropped because they were larger than a segment or a segment could not be created.
+         */
+        uint64_t droppedFrames() const;
+
+        /**
+         * @brief Builds the file name of a capture segment.
+         */
+        static std::string segmentPath(const std::string &basePath, uint32_t index);
+
+    private:
+        bool openSegment(uint32_t index);
+
+        void closeSegment();
+
+        std::string basePath;
+        size_t segmentSize;
+        size_t maxSegments;
+
+        mutable std::mutex mutex;
+        int fd = -1;
+        uint8_t *mapping = nullptr;
+        size_t used = 0;
+        uint32_t segmentIndex = 0;
+        uint32_t captureId = 0;
+        uint64_t frames = 0;
+        uint64_t dropped = 0;
+    };
+
+    /**
+     * @brief One frame read back from a capture.
+     */
+    struct CaptureRecord {
+        uint64_t timestampNs = 0;
+        FrameDirection direction = FrameDirection::Received;
+        const uint8_t *data = nullptr; // Points into the mapped segment, valid until the next call to next().
+        size_t length = 0;
+    };
+
+    /**
+     * @class CaptureReader
+     * @brief Iterates over the frames of a capture written by CaptureWriter, segment by segment.
+     */
+    class CaptureReader {
+    public:
+        explicit CaptureReader(std::string basePath);
+
+        ~CaptureReader();
+
+        CaptureReader(const CaptureReader &) = delete;
+        CaptureReader &operator=(const CaptureReader &) = delete;
+
+        /**
+         * @brief Maps the first segment found, starting at index 0.
+         * @return True if a valid segment was found.
+         */
+        bool open();
+
+        /**
+         * @brief Reads the next frame, moving on to the following segment of the same capture when needed.
+         * @param record Receives the frame.
+         * @return False once the capture is exhausted.
+         */
+        bool next(CaptureRecord &record);
+
+    private:
+        bool mapSegment(uint32_t index);
+
+        void unmapSegment();
+
+        std::string basePath;
+        const uint8_t *mapping = nullptr;
+        size_t mappedSize = 0;
+        size_t offset = 0;
+        uint32_t segmentIndex = 0;
+        uint32_t captureId = 0; // Of the first segment; a following segment with another one ends the capture.
+    };
+}
+
+#endif // YUNA_HAS_MMAP
+
+#endif //PACKETCAPTURE_H
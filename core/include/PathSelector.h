@@ -0,0 +1,88 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef PATHSELECTOR_H
+#define PATHSELECTOR_H
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace YunaProtocol {
+
+    /**
+     * @brief How DATA packets are spread over transports when a peer is reachable through several.
+     */
+    enum class MultipathMode {
+        BestPath, // Send on the best transport, falling back to the next one if sending fails.
+        Redundant, // Send on every transport that reaches the peer; receivers drop the duplicates.
+    };
+
+    /**
+     * @brief Health of one transport as a path to one peer, measured with PING/ACKNOWLEDGEMENT probes.
+     */
+    struct PathMetrics {
+        bool reachable = false; // The transport lists the peer as a client.
+        bool awaitingProbe = false; // A probe was sent and not answered yet.
+        bool hasRtt = false;
+        double smoothedRttMs = 0; // Exponentially weighted round-trip time.
+        double lossRate = 0; // Exponentially weighted share of unanswered probes, 0 to 1.
+    };
+
+    /**
+     * @class PathSelector
+     * @brief Tracks per-peer, per-transport path metrics and ranks the transports for a peer.
+     *
+     * Paths are ranked by smoothed RTT inflated by their loss rate; paths without a
+     * measurement rank after measured ones, in transport order.
+     */
+    class PathSelector {
+    public:
+        /**
+         * @brief Records that a transport can reach a peer.
+         */
+        void addPath(uint32_t peerId, size_t transportIndex);
+
+        /**
+         * @brief Records a probe sent on a transport to all of its peers. A previous probe
+         * still awaiting an answer counts as lost.
+         */
+        void onProbeSent(size_t transportIndex);
+
+        /**
+         * @brief Records a probe answer and its round-trip time.
+         */
+        void onProbeAnswered(uint32_t peerId, size_t transportIndex, double rttMs);
+
+        /**
+         * @brief Orders the transports reaching a peer, best first.
+         * @param peerId The peer.
+         * @param ranked Receives the transport indices; cleared first.
+         */
+        void rank(uint32_t peerId, std::vector<size_t> &ranked) const;
+
+        /**
+         * @brief Tells whether a transport reaches a peer.
+         */
+        bool isReachable(uint32_t peerId, size_t transportIndex) const;
+
+        /**
+         * @brief Gets the metrics of every transport for a peer, indexed by transport.
+         */
+        std::vector<PathMetrics> metrics(uint32_t peerId) const;
+
+        /**
+         * @brief Lists every peer reachable through at least one transport.
+         */
+        const std::vector<uint32_t> &peers() const;
+
+    private:
+        static double score(const PathMetrics &path);
+
+        std::unordered_map<uint32_t, std::vector<PathMetrics> > paths;
+        std::vector<uint32_t> peerIds;
+    };
+}
+
+#endif //PATHSELECTOR_H
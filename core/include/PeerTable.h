@@ -0,0 +1,94 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef PEERTABLE_H
+#define PEERTABLE_H
+#include <cstddef>
+#include <cstdint>
+
+namespace YunaProtocol {
+
+    /**
+     * @class PeerTable
+     * @brief Known peers of a transport, by client ID, in storage fixed at compile time.
+     *
+     * Entries are kept sorted by ID in an inline array and looked up by binary search, so the
+     * table never touches the heap and its size is known at link time. Peers are never removed;
+     * once the table is full, new peers are refused.
+     * @tparam Address The peer address type, default-constructible and copyable.
+     * @tparam Capacity The most peers the table holds.
+     */
+    template <typename Address, size_t Capacity>
+    class PeerTable {
+        static_assert(Capacity > 0, "A PeerTable needs room for at least one peer.");
+
+    public:
+        struct Entry {
+            uint32_t id;
+            Address address;
+        };
+
+        /**
+         * @brief Looks up the address of a peer.
+         * @return The address, or nullptr if the peer is unknown.
+         */
+        Address *find(uint32_t id) {
+            size_t index = lowerBound(id);
+            return index < count && entries[index].id == id ? &entries[index].address : nullptr;
+        }
+
+        const Address *find(uint32_t id) const {
+            return const_cast<PeerTable *>(this)->find(id);
+        }
+
+        /**
+         * @brief Adds a peer.
+         * @return False if the peer is already known or the table is full.
+         */
+        bool insert(uint32_t id, const Address& address) {
+            size_t index = lowerBound(id);
+            if ((index < count && entries[index].id == id) || count == Capacity) {
+                return false;
+            }
+            for (size_t i = count; i > index; --i) {
+                entries[i] = entries[i - 1];
+            }
+            entries[index] = {id, address};
+            count++;
+            return true;
+        }
+
+        bool full() const { return count == Capacity; }
+
+        bool empty() const { return count == 0; }
+
+        size_t size() const { return count; }
+
+        static constexpr size_t capacity() { return Capacity; }
+
+        const Entry *begin() const { return entries; }
+
+        const Entry *end() const { return entries + count; }
+
+    private:
+        size_t lowerBound(uint32_t id) const {
+            size_t low = 0;
+            size_t high = count;
+            while (low < high) {
+                size_t middle = (low + high) / 2;
+                if (entries[middle].id < id) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+            return low;
+        }
+
+        Entry entries[Capacity]{};
+        size_t count = 0;
+    };
+}
+
+#endif //PEERTABLE_H
@@ -0,0 +1,20 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef RANDOM_H
+#define RANDOM_H
+#include <cstdint>
+
+namespace YunaProtocol {
+
+    /**
+     * @brief A random 32-bit value from the platform's entropy source.
+     *
+     * std::random_device on hosts and the hardware generator on the ESP8266. Meant for the few
+     * values drawn at startup, e.g. a session or the first sequence number, not for every packet.
+     */
+    uint32_t randomUint32();
+}
+
+#endif //RANDOM_H
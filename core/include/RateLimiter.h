@@ -0,0 +1,228 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef RATELIMITER_H
+#define RATELIMITER_H
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+
+#include "Packet.h"
+
+namespace YunaProtocol {
+
+    /**
+     * @brief What happens to a packet sent while its rate limit is exhausted.
+     */
+    enum class DropPolicy {
+        DropNewest, // Discard the packet being sent.
+        DropOldest, // Queue the packet and discard the oldest queued one when the queue is full (latest value wins).
+        Block, // Make the sender wait until a token is available.
+    };
+
+    /**
+     * @brief Token bucket settings of a channel or peer.
+     */
+    struct RateLimit {
+        double packetsPerSecond = 0; // Sustained rate, tokens added per second.
+        double burst = 1; // Bucket size: packets that may be sent back to back.
+        DropPolicy policy = DropPolicy::DropNewest;
+        size_t queueDepth = 1; // Packets held back under DropOldest.
+    };
+
+    /**
+     * @brief Counters of a rate limited channel or peer.
+     */
+    struct RateLimitStats {
+        uint64_t passed = 0; // Packets sent, immediately or after waiting in the queue.
+        uint64_t droppedNewest = 0; // Packets discarded on arrival.
+        uint64_t droppedOldest = 0; // Queued packets discarded to make room for newer ones.
+        uint64_t blocked = 0; // Sends that had to wait for a token.
+        uint64_t queued = 0; // Packets that went through the DropOldest queue.
+    };
+
+    /**
+     * @class TokenBucket
+     * @brief Classic token bucket refilled continuously from a steady clock.
+     */
+    class TokenBucket {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        TokenBucket(double ratePerSecond, double burst);
+
+        /**
+         * @brief Takes one token if available.
+         * @return True if a token was taken.
+         */
+        bool tryTake(Clock::time_point now);
+
+        /**
+         * @brief Time until a token will be available, zero if one already is.
+         */
+        Clock::duration timeUntilToken(Clock::time_point now);
+
+    private:
+        void refill(Clock::time_point now);
+
+        double rate;
+        double capacity;
+        double tokens;
+        Clock::time_point lastRefill;
+    };
+
+    /**
+     * @brief Sleeps for the given duration. Without threads it spins, yielding to the Arduino core
+     * so the watchdog is fed and the network stack keeps running.
+     */
+    void rateLimiterWait(TokenBucket::Clock::duration duration);
+
+    /**
+     * @class RateLimiter
+     * @brief Applies per-key token buckets and drop policies to outgoing packets.
+     *
+     * Keys without a configured limit always pass. Packets held back by the DropOldest
+     * policy are released by drain(), in order, as tokens become available.
+     * @tparam Key The key type, e.g. a channel name or a peer ID.
+     */
+    template<class Key>
+    class RateLimiter {
+    public:
+        using Clock = TokenBucket::Clock;
+
+        enum class Verdict {
+            Send, // Send the packet now.
+            Drop, // The packet was discarded.
+            Queued, // The packet was queued and will be handed to drain() later.
+            Wait, // Blocked: wait for the returned duration, then call admit() again.
+        };
+
+        void setLimit(const Key &key, const RateLimit &limit) {
+            auto it = states.find(key);
+            if (it == states.end()) {
+                states.emplace(key, State(limit));
+            } else {
+                it->second.limit = limit;
+                it->second.bucket = TokenBucket(limit.packetsPerSecond, limit.burst);
+            }
+        }
+
+        void clearLimit(const Key &key) {
+            states.erase(key);
+        }
+
+        bool hasLimits() const {
+            return !states.empty();
+        }
+
+        /**
+         * @brief Decides whether a packet may be sent now.
+         *
+         * Under DropPolicy::Block, a caller that passes `waitOutside` gets Verdict::Wait and the time until
+         * a token is due, so it can wait after releasing its locks; without it, admit() waits itself.
+         * @param key The channel or peer the packet is charged to.
+         * @param packet The packet, copied when it is queued.
+         * @param priority The packet's scheduling class, kept with it in the queue and handed to drain().
+         * @param waitOutside Receives the time to wait when the verdict is Verdict::Wait.
+         * @param retry True when asking again after a Verdict::Wait, so the send is counted as blocked once.
+         */
+        Verdict admit(const Key &key, const Packet &packet, PriorityClass priority, Clock::duration *waitOutside = nullptr,
+                      bool retry = false) {
+            auto it = states.find(key);
+            if (it == states.end()) {
+                return Verdict::Send;
+            }
+            State &state = it->second;
+            auto now = Clock::now();
+
+            // Packets queued earlier go first, so a newcomer can only queue behind them.
+            if (state.queue.empty() && state.bucket.tryTake(now)) {
+                state.stats.passed++;
+                return Verdict::Send;
+            }
+
+            switch (state.limit.policy) {
+                case DropPolicy::DropNewest:
+                    state.stats.droppedNewest++;
+                    return Verdict::Drop;
+                case DropPolicy::DropOldest:
+                    if (state.limit.queueDepth == 0) {
+                        state.stats.droppedNewest++;
+                        return Verdict::Drop;
+                    }
+                    while (state.queue.size() >= state.limit.queueDepth) {
+                        state.queue.pop_front();
+                        state.stats.droppedOldest++;
+                    }
+                    state.queue.push_back(Queued{packet, priority});
+                    state.stats.queued++;
+                    return Verdict::Queued;
+                case DropPolicy::Block:
+                default: {
+                    auto wait = state.bucket.timeUntilToken(now);
+                    if (wait == Clock::duration::max()) { // A zero rate never refills.
+                        state.stats.droppedNewest++;
+                        return Verdict::Drop;
+                    }
+                    if (!retry) {
+                        state.stats.blocked++;
+                    }
+                    if (waitOutside) {
+                        *waitOutside = wait;
+                        return Verdict::Wait;
+                    }
+                    rateLimiterWait(wait);
+                    state.bucket.tryTake(Clock::now());
+                    state.stats.passed++;
+                    return Verdict::Send;
+                }
+            }
+        }
+
+        /**
+         * @brief Releases queued packets whose tokens have become available.
+         * @param send Called as send(key, packet, priority) for every released packet.
+         */
+        template<class SendFn>
+        void drain(SendFn &&send) {
+            auto now = Clock::now();
+            for (auto &[key, state] : states) {
+                while (!state.queue.empty() && state.bucket.tryTake(now)) {
+                    Queued queued = std::move(state.queue.front());
+                    state.queue.pop_front();
+                    state.stats.passed++;
+                    send(key, queued.packet, queued.priority);
+                }
+            }
+        }
+
+        RateLimitStats getStats(const Key &key) const {
+            auto it = states.find(key);
+            return it == states.end() ? RateLimitStats{} : it->second.stats;
+        }
+
+    private:
+        struct Queued {
+            Packet packet;
+            PriorityClass priority;
+        };
+
+        struct State {
+            explicit State(const RateLimit &limit)
+                : limit(limit), bucket(limit.packetsPerSecond, limit.burst) {
+            }
+
+            RateLimit limit;
+            TokenBucket bucket;
+            std::deque<Queued> queue;
+            RateLimitStats stats;
+        };
+
+        std::map<Key, State> states;
+    };
+}
+
+#endif //RATELIMITER_H
@@ -0,0 +1,97 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef REPLAYTRANSPORT_H
+#define REPLAYTRANSPORT_H
+#include "YunaConfig.h"
+
+#if YUNA_HAS_MMAP
+#include <chrono>
+#include <set>
+#include <string>
+
+#include "PacketCapture.h"
+#include "Transport.h"
+
+namespace YunaProtocol {
+
+    /**
+     * @class ReplayTransport
+     * @brief A YunaTransport that feeds the received frames of a capture back into a node.
+     *
+     * Frames are delivered from loop() with their original spacing scaled by the replay
+     * speed, or as fast as loop() is called when the speed is 0. Discovery frames populate
+     * listConnectedClients() exactly as a live transport would. Anything the node sends is
+     * discarded (and still shown to the frame tap).
+     */
+    class ReplayTransport : public YunaTransport {
+    public:
+        /**
+         * @param basePath The capture path prefix given to CaptureWriter.
+         * @param speed Replay speed multiplier: 1 is real time, 10 is ten times faster, 0 is as fast as possible.
+         * @param replaySentFrames Also replay frames the capturing node sent, not only those it received.
+         */
+        explicit ReplayTransport(std::string basePath, double speed = 1.0, bool replaySentFrames = false);
+
+        /**
+         * @brief Opens the capture.
+         * @return False if no capture segment was found.
+         */
+        bool initialize() override;
+
+        bool send(const Packet &packet) override;
+
+        /**
+         * @brief Discards a packet for one client like send(), after checking the client was replayed.
+         * @return False if the capture has not shown this client so far.
+         */
+        bool sendTo(uint32_t clientId, const Packet &packet) override;
+
+        /**
+         * @brief Delivers every frame that is due, at most maxFramesPerLoop per call.
+         */
+        void loop() override;
+
+        bool broadcast(const Packet &packet) override;
+
+        std::vector<uint32_t> listConnectedClients() override;
+
+        /**
+         * @brief Sets how many frames a single loop() call may deliver. Defaults to 4096.
+         */
+        void set_max_frames_per_loop(size_t frames);
+
+        /**
+         * @brief True once every frame of the capture has been delivered.
+         */
+        bool finished() const;
+
+        /**
+         * @brief Number of frames delivered to the callback so far.
+         */
+        uint64_t replayedFrames() const;
+
+    private:
+        void deliver(const CaptureRecord &record);
+
+        CaptureReader reader;
+        double speed;
+        bool replaySentFrames;
+        size_t maxFramesPerLoop = 4096;
+        bool initialized = false;
+        bool exhausted = false;
+
+        CaptureRecord pendingRecord; // Read ahead but not yet due.
+        bool hasPending = false;
+        uint64_t firstTimestampNs = 0;
+        std::chrono::steady_clock::time_point replayStart{};
+        uint64_t replayed = 0;
+
+        std::set<uint32_t> clients;
+    };
+}
+
+#endif // YUNA_HAS_MMAP
+
+#endif //REPLAYTRANSPORT_H
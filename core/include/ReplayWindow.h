@@ -0,0 +1,54 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef REPLAYWINDOW_H
+#define REPLAYWINDOW_H
+#include <cstdint>
+#include <unordered_map>
+
+namespace YunaProtocol {
+
+    /**
+     * @class ReplayWindow
+     * @brief Sliding-window replay protection over the AEAD nonces of authenticated packets.
+     *
+     * A nonce holds the sender's session in its upper 32 bits and a counter in the lower ones.
+     * Sessions only grow: a restarted sender starts a higher one (see ChannelCipher). Per source,
+     * the window keeps the current session, the highest counter seen and a 64-bit bitmap of the
+     * counters just below it. A higher session replaces the window, and anything from a lower
+     * session is rejected, so traffic captured before any number of restarts cannot be replayed.
+     * Unlike DuplicateFilter, a counter behind the window is rejected rather than taken as a restart.
+     *
+     * Only packets whose tag verified may be recorded, or forged nonces could move the window.
+     */
+    class ReplayWindow {
+    public:
+        static constexpr uint32_t WINDOW_SIZE = 64;
+
+        /**
+         * @brief Records an authenticated packet and tells whether it is fresh.
+         * @param sourceId The sending node.
+         * @param nonce The packet's 64-bit nonce: session and counter.
+         * @return True for a new packet, false for a replay.
+         */
+        bool accept(uint32_t sourceId, uint64_t nonce);
+
+        /**
+         * @brief Number of replays rejected so far.
+         */
+        uint64_t replays() const;
+
+    private:
+        struct Window {
+            uint32_t session = 0;
+            uint32_t highest = 0;
+            uint64_t bitmap = 0; // Bit n set: highest - n was seen.
+        };
+
+        std::unordered_map<uint32_t, Window> windows;
+        uint64_t rejected = 0;
+    };
+}
+
+#endif //REPLAYWINDOW_H
@@ -0,0 +1,87 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef RETAINEDCACHE_H
+#define RETAINEDCACHE_H
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace YunaProtocol {
+
+    /**
+     * @brief The last retained value published on a channel.
+     */
+    struct RetainedEntry {
+        uint32_t sourceId = 0; // The node that published the value.
+        std::vector<uint8_t> payload;
+        uint64_t lastUpdate = 0; // Store order, used to evict the stalest channel.
+    };
+
+    /**
+     * @class RetainedCache
+     * @brief Bounded last-value cache keyed by channel name.
+     *
+     * When the cache is full, storing a value for a new channel evicts the channel that
+     * was updated least recently. The cache also packs entries into RETAINED_SYNC
+     * payloads so a new peer can receive all of them in a few datagrams.
+     */
+    class RetainedCache {
+    public:
+        /**
+         * @param capacity Maximum number of channels kept.
+         * @param maxPayloadSize Larger retained payloads are not cached.
+         */
+        explicit RetainedCache(size_t capacity = 32, size_t maxPayloadSize = 1024);
+
+        /**
+         * @brief Stores the value of a channel, replacing the previous one.
+         * @return False if the payload is too large to be cached.
+         */
+        bool store(const std::string &channel, uint32_t sourceId, const std::vector<uint8_t> &payload);
+
+        /**
+         * @brief Looks up the cached value of a channel.
+         * @return The entry, or nullptr if the channel has no retained value.
+         */
+        const RetainedEntry *find(const std::string &channel) const;
+
+        void setCapacity(size_t capacity);
+
+        size_t size() const;
+
+        /**
+         * @brief Packs the entries published by a node into RETAINED_SYNC payloads.
+         * @param sourceId Only entries published by this node are included.
+         * @param maxDatagramPayload Target size of one sync payload. An entry larger than this is sent on its own.
+         * @param skip Optional predicate on the channel name: entries it accepts are left out.
+         * @return One payload per sync packet to send.
+         */
+        std::vector<std::vector<uint8_t> > encodeSync(uint32_t sourceId, size_t maxDatagramPayload,
+                                                      const std::function<bool(const std::string &)> &skip = {}) const;
+
+        /**
+         * @brief Unpacks a RETAINED_SYNC payload.
+         * @param payload The payload of a RETAINED_SYNC packet.
+         * @param visitor Called for every entry with its channel, publisher and value.
+         * @return False if the payload is malformed. Entries before the damage have already been visited.
+         */
+        static bool decodeSync(const std::vector<uint8_t> &payload,
+                               const std::function<void(const char *channel, uint32_t sourceId,
+                                                        const uint8_t *data, uint16_t length)> &visitor);
+
+    private:
+        void evictOldest();
+
+        size_t capacity;
+        size_t maxPayloadSize;
+        uint64_t clock = 0;
+        std::unordered_map<std::string, RetainedEntry> entries;
+    };
+}
+
+#endif //RETAINEDCACHE_H
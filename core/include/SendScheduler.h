@@ -0,0 +1,99 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef SENDSCHEDULER_H
+#define SENDSCHEDULER_H
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+
+#include "Packet.h"
+
+namespace YunaProtocol {
+
+    /**
+     * @brief A packet waiting in the send scheduler, with where it has to go.
+     */
+    struct OutgoingPacket {
+        static constexpr size_t ANY_TRANSPORT = std::numeric_limits<size_t>::max();
+
+        Packet packet;
+        PriorityClass priority = PriorityClass::Standard;
+        size_t transportIndex = ANY_TRANSPORT; // ANY_TRANSPORT lets the node route the packet.
+        bool unicast = false; // Send to peerId only, on transportIndex.
+        uint32_t peerId = 0;
+    };
+
+    /**
+     * @brief Counters of one priority class.
+     */
+    struct SchedulerClassStats {
+        uint64_t enqueued = 0;
+        uint64_t sent = 0;
+        uint64_t dropped = 0; // Tail drops because the class queue was full.
+        size_t queued = 0;
+    };
+
+    /**
+     * @class SendScheduler
+     * @brief Per-class queues served by strict priority for Control and weighted fair queuing for the rest.
+     *
+     * Control packets always leave first. The other classes share the link by deficit
+     * round robin: each visit credits a class with weight x quantum bytes, so their byte
+     * shares follow their weights and none of them can starve.
+     */
+    class SendScheduler {
+    public:
+        /**
+         * @param queueLimit Maximum packets queued per class before new ones are dropped.
+         * @param quantum Bytes credited per unit of weight on each round robin visit.
+         */
+        explicit SendScheduler(size_t queueLimit = 1024, size_t quantum = 1500);
+
+        /**
+         * @brief Sets the fair queuing weight of a non-Control class. Defaults: Interactive 8, Standard 4, Bulk 1.
+         */
+        void setWeight(PriorityClass priority, uint32_t weight);
+
+        /**
+         * @brief Queues a packet in its class.
+         * @return False if the class queue was full and the packet was dropped.
+         */
+        bool enqueue(OutgoingPacket item);
+
+        /**
+         * @brief Takes the next packet to send.
+         * @param item Receives the packet.
+         * @return False if every queue is empty.
+         */
+        bool dequeue(OutgoingPacket &item);
+
+        bool empty() const;
+
+        SchedulerClassStats getStats(PriorityClass priority) const;
+
+    private:
+        struct ClassQueue {
+            std::deque<OutgoingPacket> packets;
+            uint32_t weight = 1;
+            size_t deficit = 0;
+            SchedulerClassStats stats;
+        };
+
+        static size_t wireSize(const OutgoingPacket &item);
+
+        void take(ClassQueue &queue, OutgoingPacket &item);
+
+        std::array<ClassQueue, PRIORITY_CLASS_COUNT> queues;
+        size_t queueLimit;
+        size_t quantum;
+        size_t current = 1; // Class the round robin is visiting; Control (0) is never part of it.
+        bool visitCredited = false;
+        size_t queuedPackets = 0;
+    };
+}
+
+#endif //SENDSCHEDULER_H
@@ -0,0 +1,209 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef STATICNODE_H
+#define STATICNODE_H
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#include "ChannelTrie.h"
+#include "Packet.h"
+#include "Random.h"
+
+namespace YunaProtocol {
+
+    /**
+     * @brief Compile-time list of channel handlers for StaticNode.
+     *
+     * A handler is a default-constructible type with a `static constexpr const char *channel`
+     * and a call operator taking a const PacketView&. The channel may be a filter with "+" and
+     * "#" wildcards, as accepted by YunaNode::registerDataCallback(), e.g.
+     * @code
+     * struct Temperature {
+     *     static constexpr const char *channel = "sensors/temperature";
+     *     void operator()(const YunaProtocol::PacketView& packet) { ... }
+     * };
+     * @endcode
+     */
+    template <typename... Handlers>
+    struct ChannelHandlers {};
+
+    template <typename Handlers, typename... Transports>
+    class StaticNode;
+
+    /**
+     * @class StaticNode
+     * @brief A node whose transports and channel handlers are fixed at compile time.
+     *
+     * Every transport is called through its concrete type and every matching handler is selected
+     * by an unrolled comparison, so the per-packet path holds no virtual call, no std::function and
+     * no allocation, and the compiler can inline it end to end. Transports must provide
+     * poll(Sink&) and the PacketView overloads of send() and sendTo(), like LinuxTransport,
+     * XdpTransport and ESP8266Transport. They are owned by the caller, typically as globals.
+     *
+     * It covers fixed deployments: DATA packets are dispatched and PINGs answered, so dynamic
+     * nodes still see its paths as reachable. Duplicate suppression, retained values, rate limits,
+     * channel encryption and scheduling stay with YunaNode.
+     *
+     * Together with ESP8266Transport it forms the fixed-footprint profile for long-running devices:
+     * the channels are the handler list, peers and payloads are bounded by YUNA_MAX_PEERS and
+     * YUNA_MAX_PAYLOAD, and once discovery has settled nothing is allocated, so the heap cannot
+     * fragment. YunaNode keeps its dynamic, heap-based tables.
+     */
+    template <typename... Handlers, typename... Transports>
+    class StaticNode<ChannelHandlers<Handlers...>, Transports...> {
+        static_assert(sizeof...(Transports) > 0, "A StaticNode needs at least one transport.");
+        static_assert(((std::char_traits<char>::length(Handlers::channel) < sizeof(PacketHeader::channel)) && ...),
+                      "Channel names must be shorter than 32 characters.");
+
+    public:
+        /**
+         * @brief Creates the node on top of transports constructed by the caller.
+         * @param nodeID The node's 32-bit ID.
+         * @param transports The transports, which must outlive the node.
+         */
+        explicit StaticNode(uint32_t nodeID, Transports&... transports) : id(nodeID), lastSequence(randomUint32()),
+                                                                          transports(transports...) {
+            forEachTransport([this](auto& transport) { transport.setClientId(id); });
+        }
+
+        /**
+         * @brief Initializes every transport.
+         * @return True if all of them initialized.
+         */
+        bool initialize() {
+            bool initialized = true;
+            forEachTransport([&initialized](auto& transport) {
+                using Transport = std::remove_reference_t<decltype(transport)>;
+                initialized = transport.Transport::initialize() && initialized;
+            });
+            return initialized;
+        }
+
+        /**
+         * @brief Polls every transport once and runs the handlers of the received packets.
+         */
+        void loop() {
+            forEachTransport([this](auto& transport) {
+                auto sink = [this, &transport](const PacketView& packet) { handle(transport, packet); };
+                transport.poll(sink);
+            });
+        }
+
+        /**
+         * @brief Sends data to every known peer on every transport.
+         * @param channel The channel to send the data on.
+         * @param payload The payload, which is not copied.
+         * @param length The payload size.
+         * @return True if every transport sent it.
+         */
+        bool sendData(const char *channel, const uint8_t *payload, uint16_t length) {
+            PacketView packet;
+            packet.header.packetType = DATA;
+            packet.header.sourceId = id;
+            packet.header.sequence = allocateSequence();
+            std::strncpy(packet.header.channel, channel, sizeof(packet.header.channel) - 1);
+            packet.header.payloadLength = length;
+            if (integrityCheck) {
+                packet.header.flags |= PACKET_FLAG_CRC32C;
+            }
+            packet.payload = payload;
+
+            bool sent = true;
+            forEachTransport([&](auto& transport) { sent = transport.send(packet) && sent; });
+            return sent;
+        }
+
+        /**
+         * @brief Sends data on the channel of a handler type.
+         */
+        template <typename Handler>
+        bool sendData(const uint8_t *payload, uint16_t length) {
+            return sendData(Handler::channel, payload, length);
+        }
+
+        /**
+         * @brief Protects DATA packets with a CRC32C trailer and drops incoming ones without it.
+         */
+        void enableIntegrityCheck(bool enabled) {
+            integrityCheck = enabled;
+        }
+
+        uint32_t getNodeId() const {
+            return id;
+        }
+
+        /**
+         * @brief The instance of a handler, e.g. to read the state it accumulated.
+         */
+        template <typename Handler>
+        Handler& handler() {
+            return std::get<Handler>(handlers);
+        }
+
+        /**
+         * @brief The transport at a position of the template argument list.
+         */
+        template <size_t Index>
+        auto& transport() {
+            return std::get<Index>(transports);
+        }
+
+    private:
+        template <typename Function>
+        void forEachTransport(Function&& function) {
+            std::apply([&function](auto&... transport) { (function(transport), ...); }, transports);
+        }
+
+        template <typename Transport>
+        void handle(Transport& transport, const PacketView& packet) {
+            if (packet.header.packetType == PING) {
+                // Echo the probe back, payload included, like YunaNode does.
+                PacketView reply;
+                reply.header.packetType = ACKNOWLEDGEMENT;
+                reply.header.sourceId = id;
+                reply.header.sequence = allocateSequence();
+                reply.header.payloadLength = packet.header.payloadLength;
+                reply.payload = packet.payload;
+                transport.sendTo(packet.header.sourceId, reply);
+                return;
+            }
+            // It holds no channel keys, so encrypted data is dropped rather than handed over sealed.
+            if (packet.header.packetType != DATA || (packet.header.flags & PACKET_FLAG_ENCRYPTED)) {
+                return;
+            }
+            if (integrityCheck && !(packet.header.flags & PACKET_FLAG_CRC32C)) {
+                return;
+            }
+            // One comparison per handler, unrolled at compile time; every match runs, like in YunaNode.
+            std::string_view channel(packet.header.channel, strnlen(packet.header.channel, sizeof(packet.header.channel)));
+            (void) ((matches<Handlers>(channel) && (std::get<Handlers>(handlers)(packet), true)), ...);
+        }
+
+        template <typename Handler>
+        static bool matches(std::string_view channel) {
+            return ChannelTrie::matches(Handler::channel, channel);
+        }
+
+        uint32_t allocateSequence() {
+            // 0 means unsequenced, so skip it on wrap-around.
+            if (++lastSequence == 0) {
+                ++lastSequence;
+            }
+            return lastSequence;
+        }
+
+        uint32_t id;
+        bool integrityCheck = false;
+        // Starts at a random value, like YunaNode, so a restart does not land in the peers' windows.
+        uint32_t lastSequence;
+        std::tuple<Transports&...> transports;
+        std::tuple<Handlers...> handlers;
+    };
+}
+
+#endif //STATICNODE_H
@@ -4,18 +4,48 @@
 
 #ifndef TRANSPORT_H
 #define TRANSPORT_H
+#include <atomic>
 #include <functional>
 
 #include "Packet.h"
 namespace YunaProtocol {
     using DataReceivedCallback = std::function<void(const Packet& packet)>;
+    using PeerDiscoveredCallback = std::function<void(uint32_t clientId)>;
+
+    enum class FrameDirection : uint8_t {
+        Received = 0,
+        Sent = 1,
+    };
+
+    /**
+     * @class FrameTap
+     * @brief Observer of the raw datagrams a transport sends and receives, e.g. a packet capture.
+     */
+    class FrameTap {
+    public:
+        virtual ~FrameTap() = default;
+
+        /**
+         * @brief Called with every serialized frame, before decoding on receive and after a successful send.
+         * @param direction Whether the frame was received or sent.
+         * @param data The raw frame bytes, only valid for the duration of the call.
+         * @param size The frame length.
+         */
+        virtual void onFrame(FrameDirection direction, const uint8_t *data, size_t size) = 0;
+    };
+
     class YunaTransport {
 
 
     public:
 
         DataReceivedCallback callback;
+        PeerDiscoveredCallback peerDiscoveredCallback;
         uint32_t clientID = 0;
+        // Number of received datagrams whose CRC32C trailer did not match; read from other threads.
+        std::atomic<uint32_t> corruptedPackets{0};
+        // Optional observer of raw frames, not owned.
+        FrameTap *frameTap = nullptr;
         // Virtual destructor to ensure proper cleanup of derived classes.
         virtual ~YunaTransport() = default;
 
@@ -29,6 +59,15 @@ namespace YunaProtocol {
         }
 
 
+        /**
+         * @brief Attaches an observer of raw frames, or detaches it with nullptr.
+         * @param tap The observer. It must outlive the transport or be detached first.
+         */
+        void setFrameTap(FrameTap *tap) {
+            frameTap = tap;
+        }
+
+
         /**
          * @brief Initializes the transport layer.
 
@@ -43,12 +82,53 @@ namespace YunaProtocol {
         virtual bool send(const Packet& packet) = 0;
 
 
+        /**
+         * @brief Sends data to a single known client.
+         *
+         * The default implementation falls back to send(), i.e. to every client.
+         * @param clientId The destination client ID.
+         * @param packet The data packet to send.
+         * @return True if the data was sent successfully, false if the client is unknown or an error occurred.
+         */
+        virtual bool sendTo(uint32_t clientId, const Packet& packet) {
+            (void) clientId;
+            return send(packet);
+        }
+
+
+        /**
+         * @brief Sends several packets to every client, in order.
+         *
+         * Transports that can hand many datagrams to the OS at once (e.g. UDP segmentation
+         * offload) override it; the default implementation calls send() for each packet.
+         * @param packets The packets to send.
+         * @param count The number of packets.
+         * @return True if every packet was sent successfully.
+         */
+        virtual bool sendBatch(const Packet *packets, size_t count) {
+            bool sent = true;
+            for (size_t i = 0; i < count; ++i) {
+                sent = send(packets[i]) && sent;
+            }
+            return sent;
+        }
+
+
         /**
          * @brief Registers a callback to be invoked when data is received.
          * @param callback The function to call when data is received.
          */
         void registerDataReceivedCallback(const DataReceivedCallback& callback) ;
 
+        /**
+         * @brief Registers a callback to be invoked when a client is added to the client list.
+         *
+         * It is also invoked when a known client joins again (a DISCOVERY_PEER with PACKET_FLAG_JOIN),
+         * since it restarted and lost what it was sent before.
+         * @param callback The function to call with the new client's ID.
+         */
+        void registerPeerDiscoveredCallback(const PeerDiscoveredCallback& callback) ;
+
         /**
          * @brief Main loop to receive data then call callback.
 
@@ -68,6 +148,35 @@ namespace YunaProtocol {
         */
         virtual std::vector<uint32_t> listConnectedClients() = 0;
 
+        /**
+         * @brief Marks the packets sent from now on with the DSCP and socket priority of a class.
+         *
+         * The default implementation ignores it, for transports without such settings.
+         * @param priority The class of the packets about to be sent.
+         */
+        virtual void setTrafficClass(PriorityClass priority) {
+            (void) priority;
+        }
+
+    protected:
+        /**
+         * @brief Tells the registered listener that a client was added to the client list or rejoined it.
+         */
+        void notifyPeerDiscovered(uint32_t clientId) const {
+            if (peerDiscoveredCallback) {
+                peerDiscoveredCallback(clientId);
+            }
+        }
+
+        /**
+         * @brief Hands a raw frame to the frame tap, if one is attached.
+         */
+        void tapFrame(FrameDirection direction, const uint8_t *data, size_t size) const {
+            if (frameTap) {
+                frameTap->onFrame(direction, data, size);
+            }
+        }
+
     };
 }
 
@@ -0,0 +1,70 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#ifndef YUNACONFIG_H
+#define YUNACONFIG_H
+
+// Build-time feature switches shared by the core and the platform layers.
+// Every macro can be overridden from the compiler command line.
+
+// Whether std::thread and friends are available. The ESP8266 Arduino core has no threads.
+#ifndef YUNA_HAS_THREADS
+#if defined(ARDUINO)
+#define YUNA_HAS_THREADS 0
+#else
+#define YUNA_HAS_THREADS 1
+#endif
+#endif
+
+// Whether memory-mapped files (mmap) are available, required by the packet capture.
+#ifndef YUNA_HAS_MMAP
+#if defined(__unix__) || defined(__APPLE__)
+#define YUNA_HAS_MMAP 1
+#else
+#define YUNA_HAS_MMAP 0
+#endif
+#endif
+
+// Whether ChannelCipher may take its nonce session from the wall clock. Without an RTC the clock
+// restarts near the same value on every boot, so such devices must call setSession() instead.
+#ifndef YUNA_CLOCK_SESSIONS
+#if defined(ARDUINO)
+#define YUNA_CLOCK_SESSIONS 0
+#else
+#define YUNA_CLOCK_SESSIONS 1
+#endif
+#endif
+
+// Inline storage (in bytes) of a queued handler invocation; a copied Packet plus a shared callback must fit.
+#ifndef YUNA_HANDLER_TASK_CAPACITY
+#define YUNA_HANDLER_TASK_CAPACITY 128
+#endif
+
+// Maximum number of queued invocations a strand runs before yielding its worker to other strands.
+#ifndef YUNA_HANDLER_STRAND_BATCH
+#define YUNA_HANDLER_STRAND_BATCH 8
+#endif
+
+// Default number of channels kept in a node's retained last-value cache.
+#ifndef YUNA_RETAINED_CACHE_CHANNELS
+#define YUNA_RETAINED_CACHE_CHANNELS 32
+#endif
+
+// Largest retained payload that is cached, and target payload size of one RETAINED_SYNC datagram.
+#ifndef YUNA_RETAINED_MAX_PAYLOAD
+#define YUNA_RETAINED_MAX_PAYLOAD 1024
+#endif
+
+// Most peers a fixed-capacity transport (ESP8266Transport) keeps; later peers are ignored.
+#ifndef YUNA_MAX_PEERS
+#define YUNA_MAX_PEERS 16
+#endif
+
+// Largest payload a fixed-capacity transport receives. The default fills a 1472-byte UDP
+// datagram (Ethernet MTU) with the 56-byte header and the CRC32C trailer.
+#ifndef YUNA_MAX_PAYLOAD
+#define YUNA_MAX_PAYLOAD 1412
+#endif
+
+#endif //YUNACONFIG_H
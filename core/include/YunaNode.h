@@ -1,21 +1,85 @@
 #ifndef YUNANODE_H
 #define YUNANODE_H
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 
+#include "CallbackRegistry.h"
+#include "ChannelCipher.h"
+#include "DuplicateFilter.h"
+#include "HandlerExecutor.h"
+#include "LatencyHistogram.h"
+#include "Mutex.h"
 #include "Packet.h"
+#include "PathSelector.h"
+#include "RateLimiter.h"
+#include "RetainedCache.h"
+#include "SendScheduler.h"
 #include "Transport.h"
 namespace YunaProtocol {
 
+    /**
+     * @class YunaNode
+     * @brief A node of the protocol: sends data to and dispatches data from its transports' peers.
+     *
+     * sendData() may be called from any number of threads, and callbacks registered or removed
+     * at any time, including from callbacks and while loop() runs. loop() and handleDataPacket()
+     * run on one thread at a time. Received DATA packets are matched against a snapshot of the
+     * callbacks without taking a lock; the send path and the state it shares with received
+     * protocol packets (scheduler, rate limits, retained values, path metrics) are behind one mutex.
+     * The duplicate filter has its own lock and the drop counters are atomic, so their getters
+     * may be called from any thread.
+     * Transports are added during setup, before other threads start using the node.
+     */
     class YunaNode {
 
 
 
     protected:
         uint32_t id = 0;
-        std::unordered_map <std::string, DataReceivedCallback> dataCallbacks;
+        bool integrityCheck = false;
+        FrameTap *frameTap = nullptr;
+        CallbackRegistry dataCallbacks;
         std::vector<std::unique_ptr<YunaTransport>> transports;
+        RetainedCache retainedCache{YUNA_RETAINED_CACHE_CHANNELS, YUNA_RETAINED_MAX_PAYLOAD};
+        RateLimiter<std::string> channelLimiter;
+        RateLimiter<uint32_t> peerLimiter;
+        // Starts at a random value, so a restarted node's sequences land far from its peers' windows of the old ones.
+        std::atomic<uint32_t> lastSequence{0};
+        DuplicateFilter duplicateFilter;
+        // Guards duplicateFilter, which transports looped on different threads all feed.
+        Mutex duplicateMutex;
+        std::chrono::steady_clock::time_point lastDuplicatePrune{};
+        ChannelCipher channelCipher;
+        PathSelector paths;
+        std::vector<size_t> rankedPaths; // Scratch buffer reused by sendToPeer().
+        MultipathMode multipathMode = MultipathMode::BestPath;
+        std::chrono::milliseconds probeInterval{1000};
+        std::chrono::steady_clock::time_point lastProbe{};
+        SendScheduler scheduler;
+        std::unordered_map<std::string, PriorityClass> channelPriorities;
+        size_t sendBudget = 0;
+        std::vector<Packet> bulkBatch; // Consecutive Bulk packets handed to sendBatch() together.
+        std::atomic<bool> inLoop{false}; // Packets sent meanwhile wait until the end of loop() to be scheduled together.
+        // Guards the send path and the state it shares with received protocol packets, not the DATA dispatch.
+        mutable Mutex sendMutex;
+        bool latencyTracking = false;
+        // Recorded from executor workers too, hence mutable and atomic inside.
+        mutable LatencyHistogram kernelToDecodeLatency;
+        mutable LatencyHistogram decodeToHandlerLatency;
+        mutable LatencyHistogram handlerLatency;
+#if YUNA_HAS_THREADS
+        // Declared last so it is drained and joined before the state its tasks use is destroyed.
+        // Read and replaced with std::atomic_load/atomic_store, as loop() may be dispatching meanwhile.
+        std::shared_ptr<HandlerExecutor> executor;
+        std::atomic<OrderingKey> executorOrdering{OrderingKey::Channel};
+#endif
 
 
 
@@ -31,29 +95,295 @@ namespace YunaProtocol {
          uint32_t getNodeId() const;
         /**
      * @brief Registers the application callback for incoming DATA packets.
-     * @param channel The channel name to register the callback for.
+     *
+     * Channel names are hierarchical, with levels separated by '/'. The filter may use "+" for
+     * any single level and end with "#" for any remaining levels, e.g. "sensors/+/temp" or
+     * "sensors/#". A packet runs the callback of every filter it matches. Registering the same
+     * filter again replaces its callback. Safe to call from any thread, including from a callback;
+     * packets already being dispatched still see the previous callbacks.
+     * @param channel The channel name or filter to register the callback for.
      * @param callback The function to execute when a DATA packet is received.
+     * @return False if the filter is malformed, e.g. "sensors/#/temp".
+     */
+         bool registerDataCallback(const std::string& channel,DataReceivedCallback callback) ;
+
+        /**
+     * @brief Removes the callback of a channel or filter, as it was registered.
+     *
+     * Safe to call from any thread. Invocations already queued on the handler executor still run.
+     * @param channel The channel name or filter.
+     * @return False if nothing was registered for it.
      */
-         void registerDataCallback(const std::string& channel,DataReceivedCallback callback) ;
+         bool unregisterDataCallback(const std::string& channel);
 
         /**
      * @brief Sends data to a known destination node.
      * @param payload The payload to send.
      * @param channel The channel to send the data on.
+     * @param retained Keep the payload as the channel's last value, sent to peers discovered later.
      */
-         void sendData(std::vector<uint8_t> payload, const char channel[32]) ;
+         void sendData(std::vector<uint8_t> payload, const char channel[32], bool retained = false) ;
 
+        /**
+         * @brief Adds a transport. Not safe while other threads use the node.
+         */
          void addTransport(std::unique_ptr<YunaTransport> transport) ;
 
         /**
          *@brief main loop to receive data and call the registered callbacks.
          */
-            void loop() const;
+            void loop();
 
-        void handleDataPacket(const Packet& packet) const ;
+        /**
+         * @brief Handles a packet received outside of a registered transport.
+         */
+        void handleDataPacket(const Packet& packet) ;
 
          std::vector<uint32_t> listConnectedClients() ;
 
+        /**
+         * @brief Protects DATA packets with a CRC32C trailer.
+         *
+         * When enabled, sendData() appends the trailer and incoming DATA packets without one are
+         * dropped, unless they are encrypted, which authenticates them already. Packets carrying a
+         * trailer are always verified by the transports, whatever this setting.
+         * @param enabled True to send and require checksums.
+         */
+         void enableIntegrityCheck(bool enabled);
+
+        /**
+         * @brief Encrypts and authenticates a channel with ChaCha20-Poly1305 under a shared key.
+         *
+         * DATA packets sent on the channel are encrypted, and received ones must be: unencrypted,
+         * forged, altered and replayed packets are dropped. Every node on the channel needs the
+         * same key. Its retained values reach new peers as encrypted DATA packets rather than in
+         * the RETAINED_SYNC batch. Callbacks get the plaintext, with PACKET_FLAG_ENCRYPTED set.
+         * Safe to call from any thread.
+         * @param channel The channel name, matched exactly.
+         * @param key AEAD_KEY_SIZE bytes.
+         */
+         void setChannelKey(const std::string& channel, const uint8_t *key);
+
+        /**
+         * @brief Sets the session of the encryption nonces, e.g. a boot counter from persistent storage.
+         *
+         * It must be higher than at any previous start: a repeated session reuses nonces, and peers
+         * reject packets from a session older than the latest one they saw from this node. Without
+         * it, the session comes from the wall clock where YUNA_CLOCK_SESSIONS allows and the clock
+         * is set; until then, encrypted channels send nothing (EncryptionStats::noSession).
+         */
+         void setEncryptionSession(uint32_t session);
+
+        /**
+         * @brief Sends and accepts the channel unencrypted again.
+         * @return False if the channel had no key.
+         */
+         bool clearChannelKey(const std::string& channel);
+
+        /**
+         * @brief Counters of sealed, opened and rejected encrypted packets.
+         */
+         EncryptionStats getEncryptionStats() const;
+
+        /**
+         * @brief Total number of datagrams the transports dropped because their checksum did not match.
+         */
+         uint64_t getCorruptedPacketCount() const;
+
+        /**
+         * @brief Attaches a raw frame observer (e.g. a CaptureWriter) to every current and future transport.
+         * @param tap The observer, not owned, or nullptr to detach.
+         */
+         void setFrameTap(FrameTap *tap);
+
+        /**
+         * @brief Sets how many channels the retained last-value cache keeps.
+         *
+         * The cache holds retained values this node published or received. When a peer is
+         * discovered, or joins again after a restart, the values this node published are sent to
+         * it in batched RETAINED_SYNC packets.
+         * @param channels The maximum number of channels, evicting the least recently updated first.
+         */
+         void setRetainedCacheCapacity(size_t channels);
+
+        /**
+         * @brief Gets the last retained value seen on a channel.
+         * @param channel The channel name.
+         * @return A copy of the payload, taken under the send lock so concurrent sends cannot change
+         * it, or nothing if the channel has no retained value.
+         */
+         std::optional<std::vector<uint8_t>> getRetainedValue(const std::string& channel) const;
+
+        /**
+         * @brief Limits how fast sendData() may publish on a channel.
+         *
+         * Under DropPolicy::Block the sender waits without holding the send path, so loop() and other
+         * threads' sends go on meanwhile.
+         * @param channel The channel name.
+         * @param limit Rate, burst and the policy applied when the limit is hit.
+         */
+         void setChannelRateLimit(const std::string& channel, const RateLimit& limit);
+
+         void clearChannelRateLimit(const std::string& channel);
+
+        /**
+         * @brief Limits how fast DATA packets may be sent to a single peer.
+         *
+         * Once any peer limit is set, DATA packets are sent peer by peer with sendTo() instead of
+         * one send() per transport, so each peer can be charged separately. Under DropPolicy::Block the
+         * wait happens inside the flush sending the packet, which holds the send path: prefer
+         * DropOldest for peers when other threads send too.
+         * @param peerId The destination node ID.
+         * @param limit Rate, burst and the policy applied when the limit is hit.
+         */
+         void setPeerRateLimit(uint32_t peerId, const RateLimit& limit);
+
+         void clearPeerRateLimit(uint32_t peerId);
+
+        /**
+         * @brief Counters of what a channel limit passed, queued and shed.
+         */
+         RateLimitStats getChannelRateLimitStats(const std::string& channel) const;
+
+        /**
+         * @brief Counters of what a peer limit passed, queued and shed.
+         */
+         RateLimitStats getPeerRateLimitStats(uint32_t peerId) const;
+
+        /**
+         * @brief Chooses how packets reach a peer known through several transports.
+         *
+         * With a single transport every packet simply goes out on it.
+         * @param mode BestPath (default) or Redundant.
+         */
+         void setMultipathMode(MultipathMode mode);
+
+        /**
+         * @brief Sets how often every transport is probed with a PING to measure RTT and loss.
+         *
+         * Probes are only sent when more than one transport is attached.
+         * @param interval The probe period.
+         */
+         void setPathProbeInterval(std::chrono::milliseconds interval);
+
+        /**
+         * @brief Gets the measured health of each transport as a path to a peer.
+         * @param peerId The peer.
+         * @return The metrics indexed by transport, in addTransport() order.
+         */
+         std::vector<PathMetrics> getPathMetrics(uint32_t peerId) const;
+
+        /**
+         * @brief Number of received packets dropped as duplicates of an earlier one, or too late to tell.
+         */
+         uint64_t getDuplicateCount() const;
+
+        /**
+         * @brief Assigns a channel to a priority class. Channels default to PriorityClass::Standard.
+         *
+         * Control traffic (probes, acknowledgements, retained syncs) always uses PriorityClass::Control.
+         * The class also selects the DSCP and socket priority the transports mark packets with.
+         * Bulk packets are held until the end of the next loop() and consecutive ones are handed
+         * to the transports together with sendBatch(), so a transport with segmentation offload
+         * can send them in a single system call.
+         * @param channel The channel name.
+         * @param priority The class its packets are scheduled in.
+         */
+         void setChannelPriority(const std::string& channel, PriorityClass priority);
+
+        /**
+         * @brief Sets the fair queuing weight of a non-Control class.
+         */
+         void setPriorityWeight(PriorityClass priority, uint32_t weight);
+
+        /**
+         * @brief Caps how many queued packets are handed to the transports per flush.
+         *
+         * The queue is flushed after every non-Bulk sendData() outside of a callback and at the end of
+         * every loop(). Packets beyond the budget stay queued, so under load the scheduler decides
+         * which classes go first.
+         * @param packetsPerFlush The budget, or 0 for no limit.
+         */
+         void setSendBudget(size_t packetsPerFlush);
+
+        /**
+         * @brief Counters and current queue length of a priority class.
+         */
+         SchedulerClassStats getSchedulerStats(PriorityClass priority) const;
+
+        /**
+         * @brief Records per-stage latency histograms for every packet handed to a data callback.
+         *
+         * Each packet is timestamped when the node receives it from its transport and when its
+         * handler starts and ends. Transports that provide a kernel receive timestamp (see
+         * LinuxTransport::enableKernelTimestamps) also fill the socket buffer stage.
+         * @param enabled True to start recording.
+         */
+         void enableLatencyTracking(bool enabled);
+
+        /**
+         * @brief Gets the per-stage latency histograms.
+         */
+         LatencyStats getLatencyStats() const;
+
+         void resetLatencyStats();
+
+#if YUNA_HAS_THREADS
+        /**
+         * @brief Runs data callbacks on a work-stealing thread pool instead of inside loop().
+         *
+         * Packets sharing the ordering key are handled one at a time in arrival order;
+         * different keys are handled in parallel. Keys are hashed onto a fixed set of strands, so
+         * two channels may share one and wait for each other's handlers; dedicated channels never
+         * share theirs. Safe to call while loop() runs: calling it again publishes the new pool,
+         * then drains the previous one, so ordering is not kept across the switch.
+         * @param threadCount Number of worker threads. Zero switches back to inline dispatch.
+         * @param ordering Whether ordering is kept per channel or per source node.
+         * @param dedicatedChannels Channels whose handlers never queue behind another channel's,
+         * e.g. control channels next to slow ones. Only used with OrderingKey::Channel.
+         */
+        void enableHandlerExecutor(size_t threadCount, OrderingKey ordering = OrderingKey::Channel,
+                                   const std::vector<std::string>& dedicatedChannels = {});
+
+        /**
+         * @brief Queue depth and handler latency counters of the handler executor.
+         * @return The counters, all zero when the executor is disabled.
+         */
+        ExecutorStats getExecutorStats() const;
+#endif
+
+    private:
+        uint32_t allocateSequence();
+
+        // decodedNs: when the packet was decoded, carried next to it for latency tracking; 0 if unknown.
+        void handleIncoming(size_t transportIndex, const Packet& packet, uint64_t decodedNs);
+
+        void handlePlaintext(size_t transportIndex, const Packet& packet, uint64_t decodedNs);
+
+        void probePaths();
+
+        PriorityClass priorityOf(const char *channel) const;
+
+        void flushSendQueue();
+
+        void flushBulkBatch();
+
+        void sendOutgoing(const OutgoingPacket& item);
+
+        bool routesPerPeer() const;
+
+        void transmit(const Packet& packet, PriorityClass priority);
+
+        void sendToPeer(uint32_t peerId, const Packet& packet, PriorityClass priority);
+
+        void dispatchToCallback(const Packet& packet, uint64_t decodedNs) const;
+
+        void runCallback(const DataReceivedCallback& callback, const Packet& packet, uint64_t decodedNs) const;
+
+        void handleRetainedSync(const Packet& packet, uint64_t decodedNs);
+
+        void sendRetainedSync(size_t transportIndex, uint32_t peerId);
+
     };
 }
 
@@ -0,0 +1,67 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#include "CallbackRegistry.h"
+
+namespace YunaProtocol {
+
+    CallbackRegistry::CallbackRegistry() : current(new Snapshot()) {}
+
+    CallbackRegistry::~CallbackRegistry() {
+        delete current.load();
+    }
+
+    bool CallbackRegistry::add(std::string_view filter, DataReceivedCallback callback) {
+        if (!ChannelTrie::isValidFilter(filter)) {
+            return false;
+        }
+        LockGuard lock(writerMutex);
+        auto next = new Snapshot(*current.load());
+        uint32_t index = next->filters.find(filter);
+        if (index == ChannelTrie::NO_SUBSCRIPTION) {
+            // Reuse the slot of a removed callback before growing.
+            index = 0;
+            while (index < next->callbacks.size() && next->callbacks[index]) {
+                index++;
+            }
+            if (index == next->callbacks.size()) {
+                next->callbacks.emplace_back();
+            }
+            next->filters.insert(filter, index);
+        }
+        next->callbacks[index] = std::make_shared<const DataReceivedCallback>(std::move(callback));
+        publish(next);
+        return true;
+    }
+
+    bool CallbackRegistry::remove(std::string_view filter) {
+        LockGuard lock(writerMutex);
+        if (current.load()->filters.find(filter) == ChannelTrie::NO_SUBSCRIPTION) {
+            return false;
+        }
+        auto next = new Snapshot(*current.load());
+        uint32_t index = next->filters.erase(filter);
+        next->callbacks[index].reset();
+        publish(next);
+        return true;
+    }
+
+    size_t CallbackRegistry::size() const {
+        EpochDomain::ReadGuard guard(epochs);
+        return current.load()->filters.size();
+    }
+
+    void CallbackRegistry::publish(const Snapshot *next) {
+        epochs.retire(current.exchange(next));
+        epochs.reclaim();
+    }
+
+    void CallbackRegistry::reclaim() {
+        if (epochs.pending() == 0) {
+            return;
+        }
+        LockGuard lock(writerMutex);
+        epochs.reclaim();
+    }
+}
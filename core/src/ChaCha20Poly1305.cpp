@@ -0,0 +1,805 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#include "ChaCha20Poly1305.h"
+
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define YUNA_CHACHA_X86 1
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#define YUNA_CHACHA_X86 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define YUNA_CHACHA_NEON 1
+#endif
+
+#if defined(__GNUC__)
+#define YUNA_TARGET(isa) __attribute__((target(isa)))
+#else
+#define YUNA_TARGET(isa)
+#endif
+
+// One ChaCha20 quarter round and double round, written against the ADD, XOR and ROTL* macros
+// each kernel defines for its vector type.
+#define YUNA_CHACHA_QUARTER_ROUND(a, b, c, d) \
+    a = ADD(a, b); d = ROTL16(XOR(d, a));     \
+    c = ADD(c, d); b = ROTL12(XOR(b, c));     \
+    a = ADD(a, b); d = ROTL8(XOR(d, a));      \
+    c = ADD(c, d); b = ROTL7(XOR(b, c));
+
+#define YUNA_CHACHA_DOUBLE_ROUND(x)                        \
+    YUNA_CHACHA_QUARTER_ROUND(x[0], x[4], x[8], x[12])     \
+    YUNA_CHACHA_QUARTER_ROUND(x[1], x[5], x[9], x[13])     \
+    YUNA_CHACHA_QUARTER_ROUND(x[2], x[6], x[10], x[14])    \
+    YUNA_CHACHA_QUARTER_ROUND(x[3], x[7], x[11], x[15])    \
+    YUNA_CHACHA_QUARTER_ROUND(x[0], x[5], x[10], x[15])    \
+    YUNA_CHACHA_QUARTER_ROUND(x[1], x[6], x[11], x[12])    \
+    YUNA_CHACHA_QUARTER_ROUND(x[2], x[7], x[8], x[13])     \
+    YUNA_CHACHA_QUARTER_ROUND(x[3], x[4], x[9], x[14])
+
+namespace {
+    constexpr size_t BLOCK_SIZE = 64;
+    constexpr size_t POLY1305_KEY_SIZE = 32;
+    constexpr uint32_t SIGMA[4] = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574}; // "expand 32-byte k"
+
+    // Every word is little-endian on the wire, whatever the host.
+    uint32_t load32(const uint8_t *p) {
+        return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+               static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+    }
+
+    void store32(uint8_t *p, uint32_t value) {
+        p[0] = static_cast<uint8_t>(value);
+        p[1] = static_cast<uint8_t>(value >> 8);
+        p[2] = static_cast<uint8_t>(value >> 16);
+        p[3] = static_cast<uint8_t>(value >> 24);
+    }
+
+    void store64(uint8_t *p, uint64_t value) {
+        store32(p, static_cast<uint32_t>(value));
+        store32(p + 4, static_cast<uint32_t>(value >> 32));
+    }
+
+    // Called through a volatile pointer, so zeroing key material is not optimized away as a dead store.
+    void *(*const volatile zeroMemory)(void *, int, size_t) = std::memset;
+
+    void wipe(void *data, size_t length) {
+        zeroMemory(data, 0, length);
+    }
+
+    // --- ChaCha20 block kernels: each turns input states into keystream blocks ---
+
+    void blocksScalar(const uint32_t (*states)[16], uint8_t *out, size_t count) {
+#define ADD(a, b) ((a) + (b))
+#define XOR(a, b) ((a) ^ (b))
+#define ROTL(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+#define ROTL16(v) ROTL(v, 16)
+#define ROTL12(v) ROTL(v, 12)
+#define ROTL8(v) ROTL(v, 8)
+#define ROTL7(v) ROTL(v, 7)
+        for (size_t block = 0; block < count; ++block, out += BLOCK_SIZE) {
+            uint32_t x[16];
+            std::memcpy(x, states[block], sizeof(x));
+            for (int round = 0; round < 10; ++round) {
+                YUNA_CHACHA_DOUBLE_ROUND(x)
+            }
+            for (int i = 0; i < 16; ++i) {
+                store32(out + 4 * i, x[i] + states[block][i]);
+            }
+        }
+#undef ADD
+#undef XOR
+#undef ROTL
+#undef ROTL16
+#undef ROTL12
+#undef ROTL8
+#undef ROTL7
+    }
+
+#if defined(YUNA_CHACHA_X86)
+    // Lanes hold one block each, so states are transposed to one vector per state word and back.
+    YUNA_TARGET("sse2")
+    void transpose4(__m128i *rows) {
+        __m128i t0 = _mm_unpacklo_epi32(rows[0], rows[1]);
+        __m128i t1 = _mm_unpacklo_epi32(rows[2], rows[3]);
+        __m128i t2 = _mm_unpackhi_epi32(rows[0], rows[1]);
+        __m128i t3 = _mm_unpackhi_epi32(rows[2], rows[3]);
+        rows[0] = _mm_unpacklo_epi64(t0, t1);
+        rows[1] = _mm_unpackhi_epi64(t0, t1);
+        rows[2] = _mm_unpacklo_epi64(t2, t3);
+        rows[3] = _mm_unpackhi_epi64(t2, t3);
+    }
+
+    // Four blocks at once.
+    YUNA_TARGET("sse2")
+    void blocksSse2(const uint32_t (*states)[16], uint8_t *out) {
+#define ADD(a, b) _mm_add_epi32(a, b)
+#define XOR(a, b) _mm_xor_si128(a, b)
+#define ROTL(v, n) _mm_or_si128(_mm_slli_epi32(v, n), _mm_srli_epi32(v, 32 - (n)))
+#define ROTL16(v) _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xB1), 0xB1)
+#define ROTL12(v) ROTL(v, 12)
+#define ROTL8(v) ROTL(v, 8)
+#define ROTL7(v) ROTL(v, 7)
+        __m128i input[16];
+        for (int group = 0; group < 4; ++group) {
+            for (int lane = 0; lane < 4; ++lane) {
+                input[4 * group + lane] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(states[lane] + 4 * group));
+            }
+            transpose4(input + 4 * group);
+        }
+        __m128i x[16];
+        for (int i = 0; i < 16; ++i) {
+            x[i] = input[i];
+        }
+        for (int round = 0; round < 10; ++round) {
+            YUNA_CHACHA_DOUBLE_ROUND(x)
+        }
+        for (int i = 0; i < 16; ++i) {
+            x[i] = ADD(x[i], input[i]);
+        }
+        for (int group = 0; group < 4; ++group) {
+            transpose4(x + 4 * group);
+            for (int lane = 0; lane < 4; ++lane) {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + BLOCK_SIZE * lane + 16 * group), x[4 * group + lane]);
+            }
+        }
+#undef ADD
+#undef XOR
+#undef ROTL
+#undef ROTL16
+#undef ROTL12
+#undef ROTL8
+#undef ROTL7
+    }
+
+    YUNA_TARGET("avx2")
+    void transpose8(__m256i *rows) {
+        __m256i t0 = _mm256_unpacklo_epi32(rows[0], rows[1]);
+        __m256i t1 = _mm256_unpackhi_epi32(rows[0], rows[1]);
+        __m256i t2 = _mm256_unpacklo_epi32(rows[2], rows[3]);
+        __m256i t3 = _mm256_unpackhi_epi32(rows[2], rows[3]);
+        __m256i t4 = _mm256_unpacklo_epi32(rows[4], rows[5]);
+        __m256i t5 = _mm256_unpackhi_epi32(rows[4], rows[5]);
+        __m256i t6 = _mm256_unpacklo_epi32(rows[6], rows[7]);
+        __m256i t7 = _mm256_unpackhi_epi32(rows[6], rows[7]);
+        __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+        __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+        __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+        __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+        __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+        __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+        __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+        __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+        rows[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+        rows[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+        rows[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+        rows[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+        rows[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+        rows[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+        rows[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+        rows[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+    }
+
+    // Eight blocks at once.
+    YUNA_TARGET("avx2")
+    void blocksAvx2(const uint32_t (*states)[16], uint8_t *out) {
+#define ADD(a, b) _mm256_add_epi32(a, b)
+#define XOR(a, b) _mm256_xor_si256(a, b)
+#define ROTL(v, n) _mm256_or_si256(_mm256_slli_epi32(v, n), _mm256_srli_epi32(v, 32 - (n)))
+#define ROTL16(v) _mm256_shuffle_epi8(v, rotate16)
+#define ROTL12(v) ROTL(v, 12)
+#define ROTL8(v) _mm256_shuffle_epi8(v, rotate8)
+#define ROTL7(v) ROTL(v, 7)
+        const __m256i rotate16 = _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+                                                  2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+        const __m256i rotate8 = _mm256_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,
+                                                 3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+        __m256i input[16];
+        for (int lane = 0; lane < 8; ++lane) {
+            input[lane] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(states[lane]));
+            input[8 + lane] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(states[lane] + 8));
+        }
+        transpose8(input);
+        transpose8(input + 8);
+        __m256i x[16];
+        for (int i = 0; i < 16; ++i) {
+            x[i] = input[i];
+        }
+        for (int round = 0; round < 10; ++round) {
+            YUNA_CHACHA_DOUBLE_ROUND(x)
+        }
+        for (int i = 0; i < 16; ++i) {
+            x[i] = ADD(x[i], input[i]);
+        }
+        transpose8(x);
+        transpose8(x + 8);
+        for (int lane = 0; lane < 8; ++lane) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + BLOCK_SIZE * lane), x[lane]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + BLOCK_SIZE * lane + 32), x[8 + lane]);
+        }
+#undef ADD
+#undef XOR
+#undef ROTL
+#undef ROTL16
+#undef ROTL12
+#undef ROTL8
+#undef ROTL7
+    }
+#elif defined(YUNA_CHACHA_NEON)
+    // Four blocks at once; states are transposed through a small staging array.
+    void blocksNeon(const uint32_t (*states)[16], uint8_t *out) {
+#define ADD(a, b) vaddq_u32(a, b)
+#define XOR(a, b) veorq_u32(a, b)
+#define ROTL(v, n) vsriq_n_u32(vshlq_n_u32(v, n), v, 32 - (n))
+#define ROTL16(v) vreinterpretq_u32_u16(vrev32q_u16(vreinterpretq_u16_u32(v)))
+#define ROTL12(v) ROTL(v, 12)
+#define ROTL8(v) ROTL(v, 8)
+#define ROTL7(v) ROTL(v, 7)
+        uint32_t staged[16][4];
+        for (int word = 0; word < 16; ++word) {
+            for (int lane = 0; lane < 4; ++lane) {
+                staged[word][lane] = states[lane][word];
+            }
+        }
+        uint32x4_t input[16];
+        uint32x4_t x[16];
+        for (int i = 0; i < 16; ++i) {
+            input[i] = vld1q_u32(staged[i]);
+            x[i] = input[i];
+        }
+        for (int round = 0; round < 10; ++round) {
+            YUNA_CHACHA_DOUBLE_ROUND(x)
+        }
+        for (int i = 0; i < 16; ++i) {
+            vst1q_u32(staged[i], ADD(x[i], input[i]));
+        }
+        for (int lane = 0; lane < 4; ++lane) {
+            for (int word = 0; word < 16; ++word) {
+                store32(out + BLOCK_SIZE * lane + 4 * word, staged[word][lane]);
+            }
+        }
+#undef ADD
+#undef XOR
+#undef ROTL
+#undef ROTL16
+#undef ROTL12
+#undef ROTL8
+#undef ROTL7
+    }
+#endif
+
+    enum class Kernel { Scalar, Sse2, Avx2, Neon };
+
+    Kernel detectKernel() {
+#if defined(YUNA_CHACHA_X86)
+#if defined(__GNUC__)
+        if (__builtin_cpu_supports("avx2")) {
+            return Kernel::Avx2;
+        }
+        return __builtin_cpu_supports("sse2") ? Kernel::Sse2 : Kernel::Scalar;
+#else
+        int info[4];
+        __cpuid(info, 0);
+        int maxLeaf = info[0];
+        __cpuid(info, 1);
+        bool sse2 = (info[3] & (1 << 26)) != 0;
+        // AVX2 also needs the OS to save the YMM registers (OSXSAVE and XCR0).
+        bool osSavesAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+        if (osSavesAvx && maxLeaf >= 7) {
+            __cpuidex(info, 7, 0);
+            if (info[1] & (1 << 5)) {
+                return Kernel::Avx2;
+            }
+        }
+        return sse2 ? Kernel::Sse2 : Kernel::Scalar;
+#endif
+#elif defined(YUNA_CHACHA_NEON)
+        return Kernel::Neon;
+#else
+        return Kernel::Scalar;
+#endif
+    }
+
+    const Kernel detectedKernel = detectKernel();
+    Kernel kernel = detectedKernel; // ChaCha20Poly1305::useKernel() may pick a narrower one.
+
+    bool kernelAvailable(Kernel candidate) {
+        switch (candidate) {
+            case Kernel::Avx2:
+                return detectedKernel == Kernel::Avx2;
+            case Kernel::Sse2:
+                return detectedKernel == Kernel::Avx2 || detectedKernel == Kernel::Sse2;
+            case Kernel::Neon:
+                return detectedKernel == Kernel::Neon;
+            default:
+                return true;
+        }
+    }
+
+#if defined(YUNA_CHACHA_X86) || defined(YUNA_CHACHA_NEON)
+    // Blocks computed together: enough to fill the lanes several times over.
+    constexpr size_t KEYSTREAM_CAPACITY = 32;
+    // Messages whose one-time Poly1305 keys are derived together.
+    constexpr size_t MESSAGE_GROUP = 8;
+#else
+    // Blocks are computed one at a time anyway, so keep the stack small.
+    constexpr size_t KEYSTREAM_CAPACITY = 1;
+    constexpr size_t MESSAGE_GROUP = 1;
+#endif
+
+    void computeBlocks(const uint32_t (*states)[16], uint8_t *out, size_t count) {
+#if defined(YUNA_CHACHA_X86) || defined(YUNA_CHACHA_NEON)
+#if defined(YUNA_CHACHA_X86)
+        if (kernel == Kernel::Avx2) {
+            for (; count >= 8; count -= 8, states += 8, out += 8 * BLOCK_SIZE) {
+                blocksAvx2(states, out);
+            }
+        }
+        auto blocks4 = blocksSse2;
+#else
+        auto blocks4 = blocksNeon;
+#endif
+        if (kernel != Kernel::Scalar) {
+            for (; count >= 4; count -= 4, states += 4, out += 4 * BLOCK_SIZE) {
+                blocks4(states, out);
+            }
+            if (count >= 2) {
+                // Cheaper as one padded vector call than block by block.
+                uint32_t padded[4][16]{};
+                uint8_t keystream[4 * BLOCK_SIZE];
+                std::memcpy(padded, states, count * sizeof(padded[0]));
+                blocks4(padded, keystream);
+                std::memcpy(out, keystream, count * BLOCK_SIZE);
+                return;
+            }
+        }
+#endif
+        blocksScalar(states, out, count);
+    }
+
+    void xorInto(uint8_t *target, const uint8_t *keystream, size_t length) {
+        size_t i = 0;
+        for (; i + 8 <= length; i += 8) {
+            uint64_t data;
+            uint64_t key;
+            std::memcpy(&data, target + i, sizeof(data));
+            std::memcpy(&key, keystream + i, sizeof(key));
+            data ^= key;
+            std::memcpy(target + i, &data, sizeof(data));
+        }
+        for (; i < length; ++i) {
+            target[i] ^= keystream[i];
+        }
+    }
+
+    void initialState(uint32_t *state, const uint32_t *keyWords, const uint8_t *nonce) {
+        std::memcpy(state, SIGMA, sizeof(SIGMA));
+        std::memcpy(state + 4, keyWords, 8 * sizeof(uint32_t));
+        state[12] = 0; // Block counter, set per block.
+        state[13] = load32(nonce);
+        state[14] = load32(nonce + 4);
+        state[15] = load32(nonce + 8);
+    }
+
+    /**
+     * Collects keystream blocks, possibly of different messages and keys, and XORs each into its
+     * target once they are computed together.
+     */
+    class KeystreamBatch {
+    public:
+        void add(const uint32_t *state, uint32_t counter, uint8_t *target, size_t length) {
+            if (count == KEYSTREAM_CAPACITY) {
+                flush();
+            }
+            std::memcpy(states[count], state, sizeof(states[count]));
+            states[count][12] = counter;
+            targets[count] = target;
+            lengths[count] = length;
+            count++;
+        }
+
+        void flush() {
+            if (count == 0) {
+                return;
+            }
+            uint8_t keystream[KEYSTREAM_CAPACITY * BLOCK_SIZE];
+            computeBlocks(states, keystream, count);
+            for (size_t i = 0; i < count; ++i) {
+                xorInto(targets[i], keystream + i * BLOCK_SIZE, lengths[i]);
+            }
+            wipe(states, count * sizeof(states[0]));
+            wipe(keystream, count * BLOCK_SIZE);
+            count = 0;
+        }
+
+    private:
+        uint32_t states[KEYSTREAM_CAPACITY][16];
+        uint8_t *targets[KEYSTREAM_CAPACITY];
+        size_t lengths[KEYSTREAM_CAPACITY];
+        size_t count = 0;
+    };
+
+    // Queues the keystream of a message's payload, which starts at block 1.
+    void addPayloadBlocks(KeystreamBatch& keystream, const uint32_t *state, uint8_t *data, size_t length) {
+        uint32_t counter = 1;
+        for (size_t offset = 0; offset < length; offset += BLOCK_SIZE, ++counter) {
+            keystream.add(state, counter, data + offset, length - offset < BLOCK_SIZE ? length - offset : BLOCK_SIZE);
+        }
+    }
+
+    // --- Poly1305 ---
+
+#if defined(__SIZEOF_INT128__)
+    uint64_t load64(const uint8_t *p) {
+        return static_cast<uint64_t>(load32(p)) | static_cast<uint64_t>(load32(p + 4)) << 32;
+    }
+
+    // 44/44/42-bit limbs, with 64x64->128-bit products.
+    class Poly1305 {
+    public:
+        explicit Poly1305(const uint8_t *key) {
+            uint64_t t0 = load64(key);
+            uint64_t t1 = load64(key + 8);
+            r0 = t0 & 0xffc0fffffff;
+            r1 = ((t0 >> 44) | (t1 << 20)) & 0xfffffc0ffff;
+            r2 = (t1 >> 24) & 0x00ffffffc0f;
+            pad0 = load64(key + 16);
+            pad1 = load64(key + 24);
+        }
+
+        ~Poly1305() {
+            wipe(this, sizeof(*this));
+        }
+
+        // Absorbs whole 16-byte blocks.
+        void blocks(const uint8_t *data, size_t length) {
+            using u128 = unsigned __int128;
+            const uint64_t s1 = r1 * (5 << 2);
+            const uint64_t s2 = r2 * (5 << 2);
+            for (; length >= 16; data += 16, length -= 16) {
+                uint64_t t0 = load64(data);
+                uint64_t t1 = load64(data + 8);
+                h0 += t0 & MASK44;
+                h1 += ((t0 >> 44) | (t1 << 20)) & MASK44;
+                h2 += ((t1 >> 24) & MASK42) | (uint64_t{1} << 40);
+                u128 d0 = static_cast<u128>(h0) * r0 + static_cast<u128>(h1) * s2 + static_cast<u128>(h2) * s1;
+                u128 d1 = static_cast<u128>(h0) * r1 + static_cast<u128>(h1) * r0 + static_cast<u128>(h2) * s2;
+                u128 d2 = static_cast<u128>(h0) * r2 + static_cast<u128>(h1) * r1 + static_cast<u128>(h2) * r0;
+                uint64_t carry = static_cast<uint64_t>(d0 >> 44);
+                h0 = static_cast<uint64_t>(d0) & MASK44;
+                d1 += carry;
+                carry = static_cast<uint64_t>(d1 >> 44);
+                h1 = static_cast<uint64_t>(d1) & MASK44;
+                d2 += carry;
+                carry = static_cast<uint64_t>(d2 >> 42);
+                h2 = static_cast<uint64_t>(d2) & MASK42;
+                h0 += carry * 5;
+                carry = h0 >> 44;
+                h0 &= MASK44;
+                h1 += carry;
+            }
+        }
+
+        void finish(uint8_t *mac) {
+            uint64_t carry = h1 >> 44;
+            h1 &= MASK44;
+            h2 += carry;
+            carry = h2 >> 42;
+            h2 &= MASK42;
+            h0 += carry * 5;
+            carry = h0 >> 44;
+            h0 &= MASK44;
+            h1 += carry;
+            carry = h1 >> 44;
+            h1 &= MASK44;
+            h2 += carry;
+            carry = h2 >> 42;
+            h2 &= MASK42;
+            h0 += carry * 5;
+            carry = h0 >> 44;
+            h0 &= MASK44;
+            h1 += carry;
+
+            // h - p, kept only if h >= p, without branching.
+            uint64_t g0 = h0 + 5;
+            carry = g0 >> 44;
+            g0 &= MASK44;
+            uint64_t g1 = h1 + carry;
+            carry = g1 >> 44;
+            g1 &= MASK44;
+            uint64_t g2 = h2 + carry - (uint64_t{1} << 42);
+            uint64_t select = (g2 >> 63) - 1;
+            h0 = (h0 & ~select) | (g0 & select);
+            h1 = (h1 & ~select) | (g1 & select);
+            h2 = (h2 & ~select) | (g2 & select);
+
+            h0 += pad0 & MASK44;
+            carry = h0 >> 44;
+            h0 &= MASK44;
+            h1 += (((pad0 >> 44) | (pad1 << 20)) & MASK44) + carry;
+            carry = h1 >> 44;
+            h1 &= MASK44;
+            h2 += ((pad1 >> 24) & MASK42) + carry;
+            h2 &= MASK42;
+
+            store64(mac, h0 | (h1 << 44));
+            store64(mac + 8, (h1 >> 20) | (h2 << 24));
+        }
+
+    private:
+        static constexpr uint64_t MASK44 = 0xfffffffffff;
+        static constexpr uint64_t MASK42 = 0x3ffffffffff;
+
+        uint64_t r0, r1, r2;
+        uint64_t h0 = 0, h1 = 0, h2 = 0;
+        uint64_t pad0, pad1;
+    };
+#else
+    // 26-bit limbs, with 32x32->64-bit products: the portable path, e.g. for the ESP8266.
+    class Poly1305 {
+    public:
+        explicit Poly1305(const uint8_t *key) {
+            r[0] = load32(key) & 0x3ffffff;
+            r[1] = (load32(key + 3) >> 2) & 0x3ffff03;
+            r[2] = (load32(key + 6) >> 4) & 0x3ffc0ff;
+            r[3] = (load32(key + 9) >> 6) & 0x3f03fff;
+            r[4] = (load32(key + 12) >> 8) & 0x00fffff;
+            for (int i = 0; i < 4; ++i) {
+                pad[i] = load32(key + 16 + 4 * i);
+            }
+        }
+
+        ~Poly1305() {
+            wipe(this, sizeof(*this));
+        }
+
+        // Absorbs whole 16-byte blocks.
+        void blocks(const uint8_t *data, size_t length) {
+            const uint32_t s1 = r[1] * 5, s2 = r[2] * 5, s3 = r[3] * 5, s4 = r[4] * 5;
+            uint32_t h0 = h[0], h1 = h[1], h2 = h[2], h3 = h[3], h4 = h[4];
+            for (; length >= 16; data += 16, length -= 16) {
+                h0 += load32(data) & MASK26;
+                h1 += (load32(data + 3) >> 2) & MASK26;
+                h2 += (load32(data + 6) >> 4) & MASK26;
+                h3 += (load32(data + 9) >> 6) & MASK26;
+                h4 += (load32(data + 12) >> 8) | (1u << 24);
+                uint64_t d0 = mul(h0, r[0]) + mul(h1, s4) + mul(h2, s3) + mul(h3, s2) + mul(h4, s1);
+                uint64_t d1 = mul(h0, r[1]) + mul(h1, r[0]) + mul(h2, s4) + mul(h3, s3) + mul(h4, s2);
+                uint64_t d2 = mul(h0, r[2]) + mul(h1, r[1]) + mul(h2, r[0]) + mul(h3, s4) + mul(h4, s3);
+                uint64_t d3 = mul(h0, r[3]) + mul(h1, r[2]) + mul(h2, r[1]) + mul(h3, r[0]) + mul(h4, s4);
+                uint64_t d4 = mul(h0, r[4]) + mul(h1, r[3]) + mul(h2, r[2]) + mul(h3, r[1]) + mul(h4, r[0]);
+                uint32_t carry = static_cast<uint32_t>(d0 >> 26);
+                h0 = static_cast<uint32_t>(d0) & MASK26;
+                d1 += carry;
+                carry = static_cast<uint32_t>(d1 >> 26);
+                h1 = static_cast<uint32_t>(d1) & MASK26;
+                d2 += carry;
+                carry = static_cast<uint32_t>(d2 >> 26);
+                h2 = static_cast<uint32_t>(d2) & MASK26;
+                d3 += carry;
+                carry = static_cast<uint32_t>(d3 >> 26);
+                h3 = static_cast<uint32_t>(d3) & MASK26;
+                d4 += carry;
+                carry = static_cast<uint32_t>(d4 >> 26);
+                h4 = static_cast<uint32_t>(d4) & MASK26;
+                h0 += carry * 5;
+                carry = h0 >> 26;
+                h0 &= MASK26;
+                h1 += carry;
+            }
+            h[0] = h0;
+            h[1] = h1;
+            h[2] = h2;
+            h[3] = h3;
+            h[4] = h4;
+        }
+
+        void finish(uint8_t *mac) {
+            uint32_t h0 = h[0], h1 = h[1], h2 = h[2], h3 = h[3], h4 = h[4];
+            uint32_t carry = h1 >> 26;
+            h1 &= MASK26;
+            h2 += carry;
+            carry = h2 >> 26;
+            h2 &= MASK26;
+            h3 += carry;
+            carry = h3 >> 26;
+            h3 &= MASK26;
+            h4 += carry;
+            carry = h4 >> 26;
+            h4 &= MASK26;
+            h0 += carry * 5;
+            carry = h0 >> 26;
+            h0 &= MASK26;
+            h1 += carry;
+
+            // h - p, kept only if h >= p, without branching.
+            uint32_t g0 = h0 + 5;
+            carry = g0 >> 26;
+            g0 &= MASK26;
+            uint32_t g1 = h1 + carry;
+            carry = g1 >> 26;
+            g1 &= MASK26;
+            uint32_t g2 = h2 + carry;
+            carry = g2 >> 26;
+            g2 &= MASK26;
+            uint32_t g3 = h3 + carry;
+            carry = g3 >> 26;
+            g3 &= MASK26;
+            uint32_t g4 = h4 + carry - (1u << 26);
+            uint32_t select = (g4 >> 31) - 1;
+            h0 = (h0 & ~select) | (g0 & select);
+            h1 = (h1 & ~select) | (g1 & select);
+            h2 = (h2 & ~select) | (g2 & select);
+            h3 = (h3 & ~select) | (g3 & select);
+            h4 = (h4 & ~select) | (g4 & select);
+
+            // h mod 2^128, then plus the pad.
+            uint32_t w0 = h0 | (h1 << 26);
+            uint32_t w1 = (h1 >> 6) | (h2 << 20);
+            uint32_t w2 = (h2 >> 12) | (h3 << 14);
+            uint32_t w3 = (h3 >> 18) | (h4 << 8);
+            uint64_t f = static_cast<uint64_t>(w0) + pad[0];
+            store32(mac, static_cast<uint32_t>(f));
+            f = static_cast<uint64_t>(w1) + pad[1] + (f >> 32);
+            store32(mac + 4, static_cast<uint32_t>(f));
+            f = static_cast<uint64_t>(w2) + pad[2] + (f >> 32);
+            store32(mac + 8, static_cast<uint32_t>(f));
+            f = static_cast<uint64_t>(w3) + pad[3] + (f >> 32);
+            store32(mac + 12, static_cast<uint32_t>(f));
+        }
+
+    private:
+        static constexpr uint32_t MASK26 = 0x3ffffff;
+
+        static uint64_t mul(uint32_t a, uint32_t b) {
+            return static_cast<uint64_t>(a) * b;
+        }
+
+        uint32_t r[5];
+        uint32_t h[5]{};
+        uint32_t pad[4];
+    };
+#endif
+
+    // Absorbs data zero-padded to a whole number of blocks, as the AEAD construction specifies.
+    void absorbPadded(Poly1305& poly, const uint8_t *data, size_t length) {
+        size_t whole = length & ~static_cast<size_t>(15);
+        poly.blocks(data, whole);
+        if (length > whole) {
+            uint8_t last[16]{};
+            std::memcpy(last, data + whole, length - whole);
+            poly.blocks(last, sizeof(last));
+        }
+    }
+
+    void computeTag(const uint8_t *polyKey, const YunaProtocol::AeadMessage& message, uint8_t *tag) {
+        Poly1305 poly(polyKey);
+        absorbPadded(poly, message.aad, message.aadLength);
+        absorbPadded(poly, message.data, message.length);
+        uint8_t lengths[16];
+        store64(lengths, message.aadLength);
+        store64(lengths + 8, message.length);
+        poly.blocks(lengths, sizeof(lengths));
+        poly.finish(tag);
+    }
+
+    bool tagsEqual(const uint8_t *a, const uint8_t *b) {
+        // Constant time: every byte is compared, whatever differs first.
+        uint8_t difference = 0;
+        for (size_t i = 0; i < YunaProtocol::AEAD_TAG_SIZE; ++i) {
+            difference |= a[i] ^ b[i];
+        }
+        return difference == 0;
+    }
+}
+
+YunaProtocol::ChaCha20Poly1305::ChaCha20Poly1305(const uint8_t *key) {
+    for (int i = 0; i < 8; ++i) {
+        keyWords[i] = load32(key + 4 * i);
+    }
+}
+
+YunaProtocol::ChaCha20Poly1305::~ChaCha20Poly1305() {
+    wipe(keyWords, sizeof(keyWords));
+}
+
+void YunaProtocol::ChaCha20Poly1305::seal(const uint8_t *nonce, const uint8_t *aad, size_t aadLength,
+                                          uint8_t *data, size_t length, uint8_t *tag) const {
+    AeadMessage message{this, nonce, aad, aadLength, data, length, tag};
+    sealBatch(&message, 1);
+}
+
+bool YunaProtocol::ChaCha20Poly1305::open(const uint8_t *nonce, const uint8_t *aad, size_t aadLength,
+                                          uint8_t *data, size_t length, const uint8_t *tag) const {
+    // openBatch() only reads the tag.
+    AeadMessage message{this, nonce, aad, aadLength, data, length, const_cast<uint8_t *>(tag)};
+    bool authentic = false;
+    openBatch(&message, 1, &authentic);
+    return authentic;
+}
+
+const char *YunaProtocol::ChaCha20Poly1305::kernelName() {
+    switch (kernel) {
+        case Kernel::Avx2:
+            return "avx2";
+        case Kernel::Sse2:
+            return "sse2";
+        case Kernel::Neon:
+            return "neon";
+        default:
+            return "scalar";
+    }
+}
+
+bool YunaProtocol::ChaCha20Poly1305::useKernel(const char *name) {
+    const Kernel kernels[] = {Kernel::Avx2, Kernel::Sse2, Kernel::Neon, Kernel::Scalar};
+    Kernel previous = kernel;
+    for (Kernel candidate : kernels) {
+        kernel = candidate;
+        if (std::strcmp(kernelName(), name) == 0 && kernelAvailable(candidate)) {
+            return true;
+        }
+    }
+    kernel = previous;
+    return false;
+}
+
+void YunaProtocol::sealBatch(const AeadMessage *messages, size_t count) {
+    KeystreamBatch keystream;
+    uint8_t polyKeys[MESSAGE_GROUP][POLY1305_KEY_SIZE];
+    for (size_t first = 0; first < count; first += MESSAGE_GROUP) {
+        size_t group = count - first < MESSAGE_GROUP ? count - first : MESSAGE_GROUP;
+        // Block 0 of every message yields its one-time Poly1305 key, the next ones encrypt it.
+        for (size_t i = 0; i < group; ++i) {
+            const AeadMessage& message = messages[first + i];
+            uint32_t state[16];
+            initialState(state, message.cipher->keyWords, message.nonce);
+            std::memset(polyKeys[i], 0, POLY1305_KEY_SIZE);
+            keystream.add(state, 0, polyKeys[i], POLY1305_KEY_SIZE);
+            addPayloadBlocks(keystream, state, message.data, message.length);
+            wipe(state, sizeof(state));
+        }
+        keystream.flush();
+        for (size_t i = 0; i < group; ++i) {
+            computeTag(polyKeys[i], messages[first + i], messages[first + i].tag);
+        }
+    }
+    wipe(polyKeys, sizeof(polyKeys));
+}
+
+size_t YunaProtocol::openBatch(const AeadMessage *messages, size_t count, bool *authentic) {
+    KeystreamBatch keystream;
+    uint8_t polyKeys[MESSAGE_GROUP][POLY1305_KEY_SIZE];
+    size_t authenticCount = 0;
+    for (size_t first = 0; first < count; first += MESSAGE_GROUP) {
+        size_t group = count - first < MESSAGE_GROUP ? count - first : MESSAGE_GROUP;
+        uint32_t states[MESSAGE_GROUP][16];
+        for (size_t i = 0; i < group; ++i) {
+            const AeadMessage& message = messages[first + i];
+            initialState(states[i], message.cipher->keyWords, message.nonce);
+            std::memset(polyKeys[i], 0, POLY1305_KEY_SIZE);
+            keystream.add(states[i], 0, polyKeys[i], POLY1305_KEY_SIZE);
+        }
+        keystream.flush();
+        // Only messages whose tag verifies are decrypted.
+        for (size_t i = 0; i < group; ++i) {
+            const AeadMessage& message = messages[first + i];
+            uint8_t expected[AEAD_TAG_SIZE];
+            computeTag(polyKeys[i], message, expected);
+            authentic[first + i] = tagsEqual(expected, message.tag);
+            if (authentic[first + i]) {
+                authenticCount++;
+                addPayloadBlocks(keystream, states[i], message.data, message.length);
+            }
+        }
+        keystream.flush();
+        wipe(states, sizeof(states));
+    }
+    wipe(polyKeys, sizeof(polyKeys));
+    return authenticCount;
+}
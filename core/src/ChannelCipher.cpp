@@ -0,0 +1,214 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#include "ChannelCipher.h"
+
+#include <chrono>
+#include <cstring>
+
+using namespace YunaProtocol;
+
+namespace {
+    // Messages sealed together; each needs a copy of its key on the stack.
+    constexpr size_t SEAL_GROUP = 16;
+
+    std::string channelName(const PacketHeader &header) {
+        return std::string(header.channel, strnlen(header.channel, sizeof(header.channel)));
+    }
+
+    // The 96-bit nonce: the source ID, then the header's nonce, both little-endian.
+    void buildNonce(const PacketHeader &header, uint8_t *nonce) {
+        uint32_t sourceId = header.sourceId;
+        uint64_t counter = header.nonce;
+        for (size_t i = 0; i < 4; ++i) {
+            nonce[i] = static_cast<uint8_t>(sourceId >> (8 * i));
+        }
+        for (size_t i = 0; i < 8; ++i) {
+            nonce[4 + i] = static_cast<uint8_t>(counter >> (8 * i));
+        }
+    }
+
+    // 2025-01-01: a clock reading earlier than this was never set.
+    constexpr uint32_t PLAUSIBLE_CLOCK = 1735689600;
+
+    // Seconds since the Unix epoch, which fit 32 bits until 2106.
+    uint32_t clockSeconds() {
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+}
+
+ChannelCipher::ChannelCipher() : createdSecond(clockSeconds()) {
+}
+
+void ChannelCipher::setSession(uint32_t session) {
+    LockGuard lock(keyMutex);
+    nextNonce = static_cast<uint64_t>(session) << 32;
+    sessionReady = true;
+}
+
+bool ChannelCipher::freshSession() {
+    if (sessionReady) {
+        return true;
+    }
+#if YUNA_CLOCK_SESSIONS
+    // A previous run sealed only with sessions up to the second it ended in, which is no later
+    // than the second this one was created in. Wait for the next one so the two never meet.
+    uint32_t now = clockSeconds();
+    if (now >= PLAUSIBLE_CLOCK && now > createdSecond) {
+        nextNonce = static_cast<uint64_t>(now) << 32;
+        sessionReady = true;
+        return true;
+    }
+#endif
+    return false;
+}
+
+void ChannelCipher::setKey(const std::string &channel, const uint8_t *key) {
+    LockGuard lock(keyMutex);
+    keys.insert_or_assign(channel, ChaCha20Poly1305(key));
+    keyCount = keys.size();
+}
+
+bool ChannelCipher::clearKey(const std::string &channel) {
+    LockGuard lock(keyMutex);
+    bool erased = keys.erase(channel) > 0;
+    keyCount = keys.size();
+    return erased;
+}
+
+bool ChannelCipher::hasKey(const std::string &channel) const {
+    if (keyCount == 0) {
+        return false;
+    }
+    LockGuard lock(keyMutex);
+    return keys.count(channel) > 0;
+}
+
+std::vector<std::string> ChannelCipher::channels() const {
+    std::vector<std::string> names;
+    LockGuard lock(keyMutex);
+    names.reserve(keys.size());
+    for (const auto &[channel, cipher] : keys) {
+        names.push_back(channel);
+    }
+    return names;
+}
+
+bool ChannelCipher::seal(Packet *packets, size_t count) {
+    if (keyCount == 0) {
+        return true;
+    }
+    bool complete = true;
+    for (size_t first = 0; first < count; first += SEAL_GROUP) {
+        size_t group = count - first < SEAL_GROUP ? count - first : SEAL_GROUP;
+        ChaCha20Poly1305 ciphers[SEAL_GROUP];
+        Packet *selected[SEAL_GROUP];
+        size_t sealing = 0;
+        {
+            LockGuard lock(keyMutex);
+            bool ready = freshSession();
+            for (size_t i = 0; i < group; ++i) {
+                Packet &packet = packets[first + i];
+                if (packet.header.packetType != DATA || (packet.header.flags & PACKET_FLAG_ENCRYPTED)) {
+                    continue;
+                }
+                auto it = keys.find(channelName(packet.header));
+                if (it != keys.end() && !ready) {
+                    noSession++;
+                    complete = false;
+                } else if (it != keys.end()) {
+                    ciphers[sealing] = it->second;
+                    selected[sealing++] = &packet;
+                }
+            }
+        }
+        if (sealing == 0) {
+            continue;
+        }
+
+        AeadMessage messages[SEAL_GROUP];
+        uint8_t nonces[SEAL_GROUP][AEAD_NONCE_SIZE];
+        for (size_t i = 0; i < sealing; ++i) {
+            Packet &packet = *selected[i];
+            size_t length = packet.payload.size();
+            // The header is final before it is authenticated.
+            packet.payload.resize(length + AEAD_TAG_SIZE);
+            packet.header.payloadLength = static_cast<uint16_t>(packet.payload.size());
+            packet.header.flags |= PACKET_FLAG_ENCRYPTED;
+            packet.header.nonce = nextNonce++;
+            buildNonce(packet.header, nonces[i]);
+            messages[i] = {&ciphers[i], nonces[i], reinterpret_cast<const uint8_t *>(&packet.header),
+                           sizeof(PacketHeader), packet.payload.data(), length, packet.payload.data() + length};
+        }
+        sealBatch(messages, sealing);
+        sealed += sealing;
+    }
+    return complete;
+}
+
+bool ChannelCipher::needsSealing(const Packet &packet) const {
+    return packet.header.packetType == DATA && !(packet.header.flags & PACKET_FLAG_ENCRYPTED) &&
+           hasKey(channelName(packet.header));
+}
+
+bool ChannelCipher::open(const Packet &packet, Packet &plain) {
+    size_t length = packet.payload.size();
+    if (length < AEAD_TAG_SIZE) {
+        authenticationFailures++;
+        return false;
+    }
+    ChaCha20Poly1305 cipher;
+    {
+        LockGuard lock(keyMutex);
+        auto it = keys.find(channelName(packet.header));
+        if (it == keys.end()) {
+            unknownChannel++;
+            return false;
+        }
+        cipher = it->second;
+    }
+    uint8_t nonce[AEAD_NONCE_SIZE];
+    buildNonce(packet.header, nonce);
+    plain.header = packet.header;
+    plain.timestamps = packet.timestamps;
+    plain.payload.assign(packet.payload.begin(), packet.payload.end() - AEAD_TAG_SIZE);
+    // The header is authenticated as it was received, before its payload length is adjusted.
+    if (!cipher.open(nonce, reinterpret_cast<const uint8_t *>(&packet.header), sizeof(PacketHeader),
+                     plain.payload.data(), plain.payload.size(), packet.payload.data() + plain.payload.size())) {
+        authenticationFailures++;
+        return false;
+    }
+    if (!replayWindow.accept(packet.header.sourceId, packet.header.nonce)) {
+        replays++;
+        return false;
+    }
+    plain.header.payloadLength = static_cast<uint16_t>(plain.payload.size());
+    opened++;
+    return true;
+}
+
+bool ChannelCipher::acceptPlaintext(std::string_view channel) {
+    if (keyCount == 0) {
+        return true;
+    }
+    LockGuard lock(keyMutex);
+    if (keys.count(std::string(channel)) == 0) {
+        return true;
+    }
+    plaintextRejected++;
+    return false;
+}
+
+EncryptionStats ChannelCipher::getStats() const {
+    EncryptionStats stats;
+    stats.sealed = sealed;
+    stats.opened = opened;
+    stats.authenticationFailures = authenticationFailures;
+    stats.replays = replays;
+    stats.unknownChannel = unknownChannel;
+    stats.plaintextRejected = plaintextRejected;
+    stats.noSession = noSession;
+    return stats;
+}
@@ -0,0 +1,164 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#include "ChannelTrie.h"
+
+#include <algorithm>
+
+namespace YunaProtocol {
+
+    namespace {
+        // Splits off the level at the front of a name. Returns false once the name is used up.
+        bool nextLevel(std::string_view& rest, bool& hasLevel, std::string_view& level) {
+            if (!hasLevel) {
+                return false;
+            }
+            size_t separator = rest.find('/');
+            if (separator == std::string_view::npos) {
+                level = rest;
+                hasLevel = false;
+            } else {
+                level = rest.substr(0, separator);
+                rest.remove_prefix(separator + 1);
+            }
+            return true;
+        }
+
+        bool levelLess(const std::pair<std::string, uint32_t>& child, std::string_view level) {
+            return std::string_view(child.first) < level;
+        }
+    }
+
+    bool ChannelTrie::isValidFilter(std::string_view filter) {
+        std::string_view rest = filter, level;
+        bool hasLevel = true;
+        while (nextLevel(rest, hasLevel, level)) {
+            if (level == "#") {
+                if (hasLevel) {
+                    return false; // "#" must be the last level.
+                }
+            } else if (level != "+" && level.find_first_of("+#") != std::string_view::npos) {
+                return false; // Wildcards cannot share a level with other characters.
+            }
+        }
+        return true;
+    }
+
+    bool ChannelTrie::matches(std::string_view filter, std::string_view channel) {
+        std::string_view filterRest = filter, channelRest = channel, filterLevel, channelLevel;
+        bool filterHasLevel = true, channelHasLevel = true;
+        while (nextLevel(filterRest, filterHasLevel, filterLevel)) {
+            if (filterLevel == "#") {
+                return true;
+            }
+            if (!nextLevel(channelRest, channelHasLevel, channelLevel)) {
+                return false;
+            }
+            if (filterLevel != "+" && filterLevel != channelLevel) {
+                return false;
+            }
+        }
+        return !channelHasLevel;
+    }
+
+    uint32_t ChannelTrie::childOf(uint32_t node, std::string_view level) const {
+        const auto& children = nodes[node].children;
+        auto it = std::lower_bound(children.begin(), children.end(), level, levelLess);
+        return it != children.end() && it->first == level ? it->second : NO_NODE;
+    }
+
+    uint32_t ChannelTrie::addChild(uint32_t node, std::string_view level) {
+        if (level == "+") {
+            if (nodes[node].anyLevel == NO_NODE) {
+                nodes[node].anyLevel = static_cast<uint32_t>(nodes.size());
+                nodes.emplace_back();
+            }
+            return nodes[node].anyLevel;
+        }
+        auto& children = nodes[node].children;
+        auto it = std::lower_bound(children.begin(), children.end(), level, levelLess);
+        if (it != children.end() && it->first == level) {
+            return it->second;
+        }
+        auto child = static_cast<uint32_t>(nodes.size());
+        children.emplace(it, std::string(level), child);
+        nodes.emplace_back(); // After the insertion above, which still referred to nodes[node].
+        return child;
+    }
+
+    bool ChannelTrie::locate(std::string_view filter, uint32_t& node, bool& remaining) const {
+        if (!isValidFilter(filter)) {
+            return false;
+        }
+        std::string_view rest = filter, level;
+        bool hasLevel = true;
+        node = 0;
+        remaining = false;
+        while (nextLevel(rest, hasLevel, level)) {
+            if (level == "#") {
+                remaining = true;
+                return true;
+            }
+            node = level == "+" ? nodes[node].anyLevel : childOf(node, level);
+            if (node == NO_NODE) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool ChannelTrie::insert(std::string_view filter, uint32_t subscription) {
+        if (subscription == NO_SUBSCRIPTION || !isValidFilter(filter)) {
+            return false;
+        }
+        std::string_view rest = filter, level;
+        bool hasLevel = true;
+        uint32_t node = 0;
+        uint32_t *slot = nullptr;
+        while (!slot && nextLevel(rest, hasLevel, level)) {
+            if (level == "#") {
+                slot = &nodes[node].remainingLevels;
+            } else {
+                node = addChild(node, level);
+            }
+        }
+        if (!slot) {
+            slot = &nodes[node].subscription;
+        }
+        if (*slot == NO_SUBSCRIPTION) {
+            filters++;
+        }
+        *slot = subscription;
+        return true;
+    }
+
+    uint32_t ChannelTrie::find(std::string_view filter) const {
+        uint32_t node;
+        bool remaining;
+        if (!locate(filter, node, remaining)) {
+            return NO_SUBSCRIPTION;
+        }
+        return remaining ? nodes[node].remainingLevels : nodes[node].subscription;
+    }
+
+    uint32_t ChannelTrie::erase(std::string_view filter) {
+        uint32_t node;
+        bool remaining;
+        if (!locate(filter, node, remaining)) {
+            return NO_SUBSCRIPTION;
+        }
+        // Nodes are kept: filters are registered once and rarely removed.
+        uint32_t &slot = remaining ? nodes[node].remainingLevels : nodes[node].subscription;
+        uint32_t subscription = slot;
+        if (subscription != NO_SUBSCRIPTION) {
+            slot = NO_SUBSCRIPTION;
+            filters--;
+        }
+        return subscription;
+    }
+
+    size_t ChannelTrie::size() const {
+        return filters;
+    }
+}
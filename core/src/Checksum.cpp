@@ -0,0 +1,120 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#include "Checksum.h"
+
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <nmmintrin.h>
+#define YUNA_CRC32C_SSE42 1
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <nmmintrin.h>
+#define YUNA_CRC32C_SSE42 1
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define YUNA_CRC32C_ARMV8 1
+#endif
+
+namespace {
+    constexpr uint32_t CRC32C_POLY = 0x82F63B78; // Castagnoli polynomial, reflected.
+
+    struct Crc32cTable {
+        uint32_t entries[256];
+
+        constexpr Crc32cTable() : entries{} {
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t crc = i;
+                for (int bit = 0; bit < 8; ++bit) {
+                    crc = (crc >> 1) ^ ((crc & 1) ? CRC32C_POLY : 0);
+                }
+                entries[i] = crc;
+            }
+        }
+    };
+
+    constexpr Crc32cTable table{};
+
+    uint32_t crc32cSoftware(uint32_t crc, const uint8_t *data, size_t length) {
+        for (size_t i = 0; i < length; ++i) {
+            crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return crc;
+    }
+
+#if defined(YUNA_CRC32C_SSE42)
+#if defined(__GNUC__)
+    __attribute__((target("sse4.2")))
+#endif
+    uint32_t crc32cSse42(uint32_t crc, const uint8_t *data, size_t length) {
+#if defined(__x86_64__) || defined(_M_X64)
+        uint64_t crc64 = crc;
+        for (; length >= 8; data += 8, length -= 8) {
+            uint64_t word;
+            std::memcpy(&word, data, sizeof(word));
+            crc64 = _mm_crc32_u64(crc64, word);
+        }
+        crc = static_cast<uint32_t>(crc64);
+#endif
+        for (; length >= 4; data += 4, length -= 4) {
+            uint32_t word;
+            std::memcpy(&word, data, sizeof(word));
+            crc = _mm_crc32_u32(crc, word);
+        }
+        for (; length > 0; ++data, --length) {
+            crc = _mm_crc32_u8(crc, *data);
+        }
+        return crc;
+    }
+
+    bool cpuHasSse42() {
+#if defined(__GNUC__)
+        return __builtin_cpu_supports("sse4.2");
+#else
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 20)) != 0;
+#endif
+    }
+
+    const bool hardwareCrc = cpuHasSse42();
+#elif defined(YUNA_CRC32C_ARMV8)
+    uint32_t crc32cArmv8(uint32_t crc, const uint8_t *data, size_t length) {
+        for (; length >= 8; data += 8, length -= 8) {
+            uint64_t word;
+            std::memcpy(&word, data, sizeof(word));
+            crc = __crc32cd(crc, word);
+        }
+        for (; length > 0; ++data, --length) {
+            crc = __crc32cb(crc, *data);
+        }
+        return crc;
+    }
+
+    const bool hardwareCrc = true;
+#else
+    const bool hardwareCrc = false;
+#endif
+}
+
+uint32_t YunaProtocol::crc32c(const uint8_t *data, size_t length, uint32_t previous) {
+    uint32_t crc = ~previous;
+#if defined(YUNA_CRC32C_SSE42)
+    if (hardwareCrc) {
+        return ~crc32cSse42(crc, data, length);
+    }
+#elif defined(YUNA_CRC32C_ARMV8)
+    return ~crc32cArmv8(crc, data, length);
+#endif
+    return ~crc32cSoftware(crc, data, length);
+}
+
+bool YunaProtocol::crc32cIsHardwareAccelerated() {
+    return hardwareCrc;
+}
+
+uint32_t YunaProtocol::crc32cTable(const uint8_t *data, size_t length, uint32_t previous) {
+    return ~crc32cSoftware(~previous, data, length);
+}
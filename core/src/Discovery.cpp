@@ -0,0 +1,68 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#include "Discovery.h"
+
+using namespace YunaProtocol;
+
+void YunaProtocol::writePeerEntry(const PeerAddress &peer, uint8_t *entry) {
+    for (size_t i = 0; i < sizeof(peer.clientId); ++i) {
+        entry[i] = static_cast<uint8_t>(peer.clientId >> (8 * i));
+    }
+    for (size_t i = 0; i < sizeof(peer.ipv4); ++i) {
+        entry[4 + i] = static_cast<uint8_t>(peer.ipv4 >> (24 - 8 * i));
+    }
+    entry[8] = static_cast<uint8_t>(peer.port >> 8);
+    entry[9] = static_cast<uint8_t>(peer.port);
+}
+
+PeerAddress YunaProtocol::readPeerEntry(const uint8_t *entry) {
+    PeerAddress peer;
+    for (size_t i = 0; i < sizeof(peer.clientId); ++i) {
+        peer.clientId |= static_cast<uint32_t>(entry[i]) << (8 * i);
+    }
+    for (size_t i = 0; i < sizeof(peer.ipv4); ++i) {
+        peer.ipv4 = peer.ipv4 << 8 | entry[4 + i];
+    }
+    peer.port = static_cast<uint16_t>(entry[8] << 8 | entry[9]);
+    return peer;
+}
+
+JoinSchedule::JoinSchedule(uint8_t attempts, uint32_t firstRetryMs)
+    : attempts(attempts), firstRetryMs(firstRetryMs) {
+}
+
+void JoinSchedule::start(uint32_t nowMs, uint32_t seed) {
+    remaining = attempts;
+    delayMs = firstRetryMs;
+    nextAtMs = nowMs;
+    randomState = seed ? seed : 1;
+}
+
+bool JoinSchedule::due(uint32_t nowMs) {
+    // Signed difference, so the comparison survives the clock wrapping around.
+    if (remaining == 0 || static_cast<int32_t>(nowMs - nextAtMs) < 0) {
+        return false;
+    }
+    remaining--;
+    nextAtMs = nowMs + delayMs / 2 + nextRandom() % (delayMs + 1);
+    delayMs *= 2;
+    return true;
+}
+
+void JoinSchedule::onReply() {
+    remaining = 0;
+}
+
+bool JoinSchedule::active() const {
+    return remaining > 0;
+}
+
+uint32_t JoinSchedule::nextRandom() {
+    // xorshift32: enough to spread retries, and available on every platform.
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
@@ -0,0 +1,61 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#include "DuplicateFilter.h"
+
+#include <iterator>
+
+using namespace YunaProtocol;
+
+bool DuplicateFilter::accept(uint32_t sourceId, uint32_t sequence) {
+    if (sequence == 0) {
+        return true;
+    }
+    Clock::time_point now = Clock::now();
+    auto it = windows.find(sourceId);
+    if (it == windows.end()) {
+        windows.emplace(sourceId, Window{sequence, 1, now});
+        return true;
+    }
+    Window &window = it->second;
+    window.lastSeen = now;
+    auto ahead = static_cast<int32_t>(sequence - window.highest);
+    if (ahead > 0) {
+        window.bitmap = static_cast<uint32_t>(ahead) >= WINDOW_SIZE ? 1 : (window.bitmap << ahead) | 1;
+        window.highest = sequence;
+        return true;
+    }
+    auto behind = static_cast<uint32_t>(-static_cast<int64_t>(ahead));
+    if (behind >= STALE_BAND) {
+        // Too old to be a late copy: the source restarted its counter.
+        window.highest = sequence;
+        window.bitmap = 1;
+        return true;
+    }
+    if (behind >= WINDOW_SIZE) {
+        rejected++; // Late, and no longer known whether it was seen.
+        return false;
+    }
+    uint64_t bit = uint64_t{1} << behind;
+    if (window.bitmap & bit) {
+        rejected++;
+        return false;
+    }
+    window.bitmap |= bit;
+    return true;
+}
+
+void DuplicateFilter::forget(uint32_t sourceId) {
+    windows.erase(sourceId);
+}
+
+void DuplicateFilter::prune(Clock::time_point idleSince) {
+    for (auto it = windows.begin(); it != windows.end();) {
+        it = it->second.lastSeen < idleSince ? windows.erase(it) : std::next(it);
+    }
+}
+
+uint64_t DuplicateFilter::duplicates() const {
+    return rejected;
+}
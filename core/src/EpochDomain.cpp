@@ -0,0 +1,51 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#include "EpochDomain.h"
+
+namespace YunaProtocol {
+
+    EpochDomain::~EpochDomain() {
+        for (const Retired &entry : retired) {
+            entry.deleter(entry.object);
+        }
+    }
+
+    void EpochDomain::retire(void *object, void (*deleter)(void *)) {
+        // Tagged after the object was replaced, so every reader that may hold it entered at this epoch or before.
+        retired.push_back({object, deleter, epoch.load()});
+        retiredCount.store(retired.size());
+    }
+
+    void EpochDomain::tryAdvance() {
+        // Readers that entered in the previous epoch are counted in the other slot; wait until they are gone.
+        uint32_t current = epoch.load();
+        if (readers[(current + 1) & 1].load() == 0) {
+            epoch.store(current + 1);
+        }
+    }
+
+    void EpochDomain::reclaim() {
+        if (retired.empty()) {
+            return;
+        }
+        tryAdvance();
+        tryAdvance();
+        uint32_t current = epoch.load();
+        size_t kept = 0;
+        for (const Retired &entry : retired) {
+            if (current - entry.epoch >= 2) {
+                entry.deleter(entry.object);
+            } else {
+                retired[kept++] = entry;
+            }
+        }
+        retired.resize(kept);
+        retiredCount.store(kept);
+    }
+
+    size_t EpochDomain::pending() const {
+        return retiredCount.load();
+    }
+}
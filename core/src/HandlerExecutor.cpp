@@ -0,0 +1,205 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#include "HandlerExecutor.h"
+
+#include <algorithm>
+
+#if YUNA_HAS_THREADS
+using namespace YunaProtocol;
+
+HandlerExecutor::HandlerExecutor(size_t threadCount, size_t strandCount, std::vector<uint32_t> dedicatedKeys)
+    : dedicatedKeys(std::move(dedicatedKeys)) {
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+    if (strandCount == 0) {
+        strandCount = 1;
+    }
+    std::sort(this->dedicatedKeys.begin(), this->dedicatedKeys.end());
+    this->dedicatedKeys.erase(std::unique(this->dedicatedKeys.begin(), this->dedicatedKeys.end()),
+                              this->dedicatedKeys.end());
+    hashedStrands = strandCount;
+    strandCount += this->dedicatedKeys.size();
+    strands.reserve(strandCount);
+    for (size_t i = 0; i < strandCount; ++i) {
+        auto strand = std::make_unique<Strand>();
+        strand->homeWorker = i % threadCount;
+        strands.push_back(std::move(strand));
+    }
+    workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    // Start the threads only once every worker exists, since they steal from each other.
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers[i]->thread = std::thread(&HandlerExecutor::workerLoop, this, i);
+    }
+}
+
+HandlerExecutor::~HandlerExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (auto &worker : workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+HandlerExecutor::Strand *HandlerExecutor::strandFor(uint32_t key) const {
+    auto it = std::lower_bound(dedicatedKeys.begin(), dedicatedKeys.end(), key);
+    if (it != dedicatedKeys.end() && *it == key) {
+        return strands[hashedStrands + static_cast<size_t>(it - dedicatedKeys.begin())].get();
+    }
+    return strands[key % hashedStrands].get();
+}
+
+void HandlerExecutor::submit(uint32_t key, Task task) {
+    Strand *strand = strandFor(key);
+    bool needsScheduling = false;
+    {
+        std::lock_guard<std::mutex> lock(strand->mutex);
+        strand->pending.push_back(Item{std::move(task), Clock::now()});
+        if (!strand->scheduled) {
+            strand->scheduled = true;
+            needsScheduling = true;
+        }
+    }
+    submitted.fetch_add(1, std::memory_order_relaxed);
+    updateMax(maxDepth, depth.fetch_add(1, std::memory_order_relaxed) + 1);
+
+    if (needsScheduling) {
+        schedule(strand, strand->homeWorker);
+    }
+}
+
+size_t HandlerExecutor::queueDepth() const {
+    return depth.load(std::memory_order_relaxed);
+}
+
+ExecutorStats HandlerExecutor::getStats() const {
+    ExecutorStats stats;
+    stats.submitted = submitted.load(std::memory_order_relaxed);
+    stats.executed = executed.load(std::memory_order_relaxed);
+    stats.steals = steals.load(std::memory_order_relaxed);
+    stats.queueDepth = depth.load(std::memory_order_relaxed);
+    stats.maxQueueDepth = static_cast<size_t>(maxDepth.load(std::memory_order_relaxed));
+    stats.totalQueueDelayNs = totalQueueDelayNs.load(std::memory_order_relaxed);
+    stats.maxQueueDelayNs = maxQueueDelayNs.load(std::memory_order_relaxed);
+    stats.totalHandlerNs = totalHandlerNs.load(std::memory_order_relaxed);
+    stats.maxHandlerNs = maxHandlerNs.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void HandlerExecutor::schedule(Strand *strand, size_t workerIndex) {
+    {
+        std::lock_guard<std::mutex> lock(workers[workerIndex]->mutex);
+        workers[workerIndex]->runQueue.push_back(strand);
+    }
+    readyStrands.fetch_add(1);
+    {
+        // Taking the lock orders this notify after any sleeper's predicate check.
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wakeUp.notify_one();
+}
+
+HandlerExecutor::Strand *HandlerExecutor::popLocal(size_t index) {
+    Worker &worker = *workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.runQueue.empty()) {
+        return nullptr;
+    }
+    Strand *strand = worker.runQueue.front();
+    worker.runQueue.pop_front();
+    readyStrands.fetch_sub(1);
+    return strand;
+}
+
+HandlerExecutor::Strand *HandlerExecutor::steal(size_t index) {
+    for (size_t offset = 1; offset < workers.size(); ++offset) {
+        Worker &victim = *workers[(index + offset) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.runQueue.empty()) {
+            continue;
+        }
+        Strand *strand = victim.runQueue.back();
+        victim.runQueue.pop_back();
+        readyStrands.fetch_sub(1);
+        steals.fetch_add(1, std::memory_order_relaxed);
+        return strand;
+    }
+    return nullptr;
+}
+
+void HandlerExecutor::workerLoop(size_t index) {
+    while (true) {
+        Strand *strand = popLocal(index);
+        if (!strand) {
+            strand = steal(index);
+        }
+        if (strand) {
+            runStrand(strand, index);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeUp.wait(lock, [this] { return stopping.load() || readyStrands.load() > 0; });
+        if (stopping.load() && readyStrands.load() == 0) {
+            return;
+        }
+    }
+}
+
+void HandlerExecutor::runStrand(Strand *strand, size_t workerIndex) {
+    for (int ran = 0; ran < YUNA_HANDLER_STRAND_BATCH; ++ran) {
+        Item item;
+        {
+            std::lock_guard<std::mutex> lock(strand->mutex);
+            if (strand->pending.empty()) {
+                strand->scheduled = false;
+                return;
+            }
+            item = std::move(strand->pending.front());
+            strand->pending.pop_front();
+        }
+        depth.fetch_sub(1, std::memory_order_relaxed);
+
+        auto startedAt = Clock::now();
+        auto queueDelay = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(startedAt - item.enqueuedAt).count());
+        totalQueueDelayNs.fetch_add(queueDelay, std::memory_order_relaxed);
+        updateMax(maxQueueDelayNs, queueDelay);
+
+        item.task();
+
+        auto handlerTime = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - startedAt).count());
+        totalHandlerNs.fetch_add(handlerTime, std::memory_order_relaxed);
+        updateMax(maxHandlerNs, handlerTime);
+        executed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Batch exhausted: go to the back of this worker's queue so other strands get a turn.
+    {
+        std::lock_guard<std::mutex> lock(strand->mutex);
+        if (strand->pending.empty()) {
+            strand->scheduled = false;
+            return;
+        }
+    }
+    schedule(strand, workerIndex);
+}
+
+void HandlerExecutor::updateMax(std::atomic<uint64_t> &target, uint64_t value) {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+#endif // YUNA_HAS_THREADS
@@ -0,0 +1,53 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#include "LatencyHistogram.h"
+
+#include <chrono>
+
+using namespace YunaProtocol;
+
+uint64_t YunaProtocol::wallClockNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds) {
+    size_t bucket = 0;
+    while (nanoseconds > 1 && bucket + 1 < buckets.size()) {
+        nanoseconds >>= 1;
+        bucket++;
+    }
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+HistogramSnapshot LatencyHistogram::snapshot() const {
+    HistogramSnapshot snapshot;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        snapshot.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+        snapshot.count += snapshot.buckets[i];
+    }
+    if (snapshot.count == 0) {
+        return snapshot;
+    }
+    auto upperBound = [](size_t bucket) { return (uint64_t{2} << bucket) - 1; };
+    uint64_t seen = 0;
+    for (size_t i = 0; i < snapshot.buckets.size(); ++i) {
+        if (snapshot.buckets[i] == 0) {
+            continue;
+        }
+        seen += snapshot.buckets[i];
+        if (snapshot.p50Ns == 0 && seen * 100 >= snapshot.count * 50) snapshot.p50Ns = upperBound(i);
+        if (snapshot.p90Ns == 0 && seen * 100 >= snapshot.count * 90) snapshot.p90Ns = upperBound(i);
+        if (snapshot.p99Ns == 0 && seen * 100 >= snapshot.count * 99) snapshot.p99Ns = upperBound(i);
+        snapshot.maxNs = upperBound(i);
+    }
+    return snapshot;
+}
+
+void LatencyHistogram::reset() {
+    for (auto &bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
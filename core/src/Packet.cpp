@@ -5,34 +5,105 @@
 #include "Packet.h"
 
 #include <cstring>
+
+#include "Checksum.h"
 using namespace YunaProtocol;
 bool Packet::serialize(std::vector<uint8_t> &buffer) const {
-    size_t payloadSize = payload.size();
-    size_t headerSize = sizeof(PacketHeader);
-    size_t totalSize = headerSize+ payloadSize;
-   buffer.resize(totalSize);
+    PacketView packet = view();
+    buffer.resize(packet.serializedSize());
+    return packet.serialize(buffer.data(), buffer.size()) == buffer.size();
+}
 
-    std::memcpy(buffer.data(), &header, headerSize);
-    if (payloadSize > 0) {
-        std::memcpy(buffer.data() + headerSize, payload.data(), payloadSize);
-    }
-    return true;
+PacketView Packet::view() const {
+    PacketView packet;
+    packet.header = header;
+    packet.header.payloadLength = static_cast<uint16_t>(payload.size());
+    packet.payload = payload.data();
+    packet.timestamps = timestamps;
+    return packet;
 }
 
 bool Packet::deserialize(const uint8_t *buffer, size_t size) {
+    return decode(buffer, size) == DecodeStatus::Ok;
+}
+
+DecodeStatus Packet::decode(const uint8_t *buffer, size_t size) {
+    PacketView view;
+    DecodeStatus status = view.decode(buffer, size);
+    header = view.header;
+    if (status != DecodeStatus::Ok) {
+        return status;
+    }
+    payload.assign(view.payload, view.payload + header.payloadLength);
+    return DecodeStatus::Ok;
+}
+
+DecodeStatus PacketView::decode(const uint8_t *buffer, size_t size) {
     if (size < sizeof(PacketHeader)) {
-        return false;
+        return DecodeStatus::Truncated;
 
     }
     std::memcpy(&header,buffer,sizeof(PacketHeader));
+    if (header.protocolVersion != PROTOCOL_VERSION) {
+        return DecodeStatus::UnsupportedVersion;
+    }
 
     if (size-sizeof(PacketHeader) < header.payloadLength) {
-        return false;
+        return DecodeStatus::Truncated;
+
+    }
+    if (header.flags & PACKET_FLAG_CRC32C) {
+        size_t checkedSize = sizeof(PacketHeader) + header.payloadLength;
+        if (size - checkedSize < PACKET_CHECKSUM_SIZE) {
+            return DecodeStatus::Truncated;
+        }
+        uint32_t expected = 0;
+        for (size_t i = 0; i < PACKET_CHECKSUM_SIZE; ++i) {
+            expected |= static_cast<uint32_t>(buffer[checkedSize + i]) << (8 * i);
+        }
+        if (crc32c(buffer, checkedSize) != expected) {
+            return DecodeStatus::ChecksumMismatch;
+        }
+    }
+    payload = buffer + sizeof(PacketHeader);
+    return DecodeStatus::Ok;
+
+}
+
+size_t PacketView::serializedSize() const {
+    bool withChecksum = (header.flags & PACKET_FLAG_CRC32C) != 0;
+    return sizeof(PacketHeader) + header.payloadLength + (withChecksum ? PACKET_CHECKSUM_SIZE : 0);
+}
 
+size_t PacketView::serialize(uint8_t *buffer, size_t capacity) const {
+    size_t totalSize = serializedSize();
+    if (capacity < totalSize) {
+        return 0;
+    }
+    std::memcpy(buffer, &header, sizeof(PacketHeader));
+    if (header.payloadLength > 0) {
+        std::memcpy(buffer + sizeof(PacketHeader), payload, header.payloadLength);
+    }
+    if (header.flags & PACKET_FLAG_CRC32C) {
+        size_t checkedSize = sizeof(PacketHeader) + header.payloadLength;
+        uint32_t crc = crc32c(buffer, checkedSize);
+        // Little-endian on the wire regardless of the host.
+        for (size_t i = 0; i < PACKET_CHECKSUM_SIZE; ++i) {
+            buffer[checkedSize + i] = static_cast<uint8_t>(crc >> (8 * i));
+        }
     }
-    payload.resize(header.payloadLength);
-    std::memcpy(payload.data(), buffer + sizeof(PacketHeader), header.payloadLength);
-    return true;
+    return totalSize;
+}
 
+uint32_t PacketView::checksum() const {
+    uint32_t crc = crc32c(reinterpret_cast<const uint8_t *>(&header), sizeof(PacketHeader));
+    return header.payloadLength > 0 ? crc32c(payload, header.payloadLength, crc) : crc;
 }
 
+Packet PacketView::toPacket() const {
+    Packet packet;
+    packet.header = header;
+    packet.payload.assign(payload, payload + header.payloadLength);
+    packet.timestamps = timestamps;
+    return packet;
+}
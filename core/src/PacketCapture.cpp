@@ -0,0 +1,286 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#include "PacketCapture.h"
+
+#if YUNA_HAS_MMAP
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "LatencyHistogram.h"
+
+using namespace YunaProtocol;
+
+namespace {
+    constexpr size_t RECORD_ALIGNMENT = 8;
+
+    size_t alignRecord(size_t size) {
+        return (size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+    }
+
+    // Splits "<base>.<index>.ycap" and returns the index, or -1 when the name is not a segment of base.
+    long segmentIndexOf(const std::string &fileName, const std::string &baseName) {
+        const std::string suffix = ".ycap";
+        if (fileName.size() <= baseName.size() + 1 + suffix.size() ||
+            fileName.compare(0, baseName.size(), baseName) != 0 || fileName[baseName.size()] != '.' ||
+            fileName.compare(fileName.size() - suffix.size(), suffix.size(), suffix) != 0) {
+            return -1;
+        }
+        std::string digits = fileName.substr(baseName.size() + 1,
+                                             fileName.size() - baseName.size() - 1 - suffix.size());
+        if (digits.empty() || digits.find_first_not_of("0123456789") != std::string::npos) {
+            return -1;
+        }
+        return std::stol(digits);
+    }
+
+    // Indices of the segment files of a capture path prefix found on disk.
+    std::vector<uint32_t> listSegments(const std::string &basePath) {
+        std::string directory = ".";
+        std::string baseName = basePath;
+        size_t slash = basePath.find_last_of('/');
+        if (slash != std::string::npos) {
+            directory = slash == 0 ? "/" : basePath.substr(0, slash);
+            baseName = basePath.substr(slash + 1);
+        }
+        std::vector<uint32_t> indices;
+        DIR *dir = opendir(directory.c_str());
+        if (!dir) {
+            return indices;
+        }
+        while (dirent *entry = readdir(dir)) {
+            long index = segmentIndexOf(entry->d_name, baseName);
+            if (index >= 0) {
+                indices.push_back(static_cast<uint32_t>(index));
+            }
+        }
+        closedir(dir);
+        return indices;
+    }
+}
+
+// --- CaptureWriter ---
+
+CaptureWriter::CaptureWriter(std::string basePath, size_t segmentSize, size_t maxSegments)
+    : basePath(std::move(basePath)),
+      segmentSize(segmentSize < 4096 ? 4096 : segmentSize),
+      maxSegments(maxSegments) {
+}
+
+CaptureWriter::~CaptureWriter() {
+    close();
+}
+
+std::string CaptureWriter::segmentPath(const std::string &basePath, uint32_t index) {
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".%06u.ycap", index);
+    return basePath + suffix;
+}
+
+bool CaptureWriter::open() {
+    std::lock_guard<std::mutex> lock(mutex);
+    closeSegment();
+    // A shorter capture must not be followed by the segments of an earlier, longer one.
+    for (uint32_t index : listSegments(basePath)) {
+        std::remove(segmentPath(basePath, index).c_str());
+    }
+    uint64_t now = wallClockNs();
+    captureId = static_cast<uint32_t>(now ^ (now >> 32));
+    return openSegment(0);
+}
+
+void CaptureWriter::close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    closeSegment();
+}
+
+bool CaptureWriter::openSegment(uint32_t index) {
+    std::string path = segmentPath(basePath, index);
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to create capture segment " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(segmentSize)) != 0) {
+        std::cerr << "Failed to size capture segment " << path << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    void *address = mmap(nullptr, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+        std::cerr << "Failed to map capture segment " << path << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    mapping = static_cast<uint8_t *>(address);
+    segmentIndex = index;
+
+    CaptureFileHeader header;
+    header.segmentIndex = index;
+    header.captureId = captureId;
+    header.createdNs = wallClockNs();
+    std::memcpy(mapping, &header, sizeof(header));
+    used = alignRecord(sizeof(header));
+
+    if (maxSegments > 0 && index >= maxSegments) {
+        std::remove(segmentPath(basePath, static_cast<uint32_t>(index - maxSegments)).c_str());
+    }
+    return true;
+}
+
+void CaptureWriter::closeSegment() {
+    if (mapping) {
+        munmap(mapping, segmentSize);
+        mapping = nullptr;
+    }
+    if (fd >= 0) {
+        // Drop the unused preallocated tail.
+        if (ftruncate(fd, static_cast<off_t>(used)) != 0) {
+            std::cerr << "Failed to trim capture segment: " << std::strerror(errno) << std::endl;
+        }
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+void CaptureWriter::onFrame(FrameDirection direction, const uint8_t *data, size_t size) {
+    size_t recordSize = alignRecord(sizeof(CaptureRecordHeader) + size);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!mapping || recordSize > segmentSize - alignRecord(sizeof(CaptureFileHeader))) {
+        dropped++;
+        return;
+    }
+    // Keep room for a zeroed record header so readers always find an end marker.
+    if (used + recordSize + sizeof(CaptureRecordHeader) > segmentSize) {
+        uint32_t nextIndex = segmentIndex + 1;
+        closeSegment();
+        if (!openSegment(nextIndex)) {
+            dropped++;
+            return;
+        }
+    }
+
+    CaptureRecordHeader record;
+    record.timestampNs = wallClockNs();
+    record.length = static_cast<uint32_t>(size);
+    record.direction = static_cast<uint8_t>(direction);
+    std::memcpy(mapping + used, &record, sizeof(record));
+    std::memcpy(mapping + used + sizeof(record), data, size);
+    used += recordSize;
+    frames++;
+}
+
+uint64_t CaptureWriter::capturedFrames() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return frames;
+}
+
+uint64_t CaptureWriter::droppedFrames() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return dropped;
+}
+
+// --- CaptureReader ---
+
+CaptureReader::CaptureReader(std::string basePath) : basePath(std::move(basePath)) {
+}
+
+CaptureReader::~CaptureReader() {
+    unmapSegment();
+}
+
+bool CaptureReader::open() {
+    unmapSegment();
+
+    // Ring captures may have deleted the first segments, so look for the lowest index on disk.
+    std::vector<uint32_t> indices = listSegments(basePath);
+    if (indices.empty()) {
+        return false;
+    }
+    if (!mapSegment(*std::min_element(indices.begin(), indices.end()))) {
+        return false;
+    }
+    CaptureFileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    captureId = header.captureId;
+    return true;
+}
+
+bool CaptureReader::mapSegment(uint32_t index) {
+    unmapSegment();
+    int fd = ::open(CaptureWriter::segmentPath(basePath, index).c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(CaptureFileHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void *address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        return false;
+    }
+    mapping = static_cast<const uint8_t *>(address);
+    mappedSize = static_cast<size_t>(info.st_size);
+
+    CaptureFileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    if (std::memcmp(header.magic, "YCAP", 4) != 0 || header.version != 1) {
+        unmapSegment();
+        return false;
+    }
+    offset = alignRecord(sizeof(header));
+    segmentIndex = index;
+    return true;
+}
+
+void CaptureReader::unmapSegment() {
+    if (mapping) {
+        munmap(const_cast<uint8_t *>(mapping), mappedSize);
+        mapping = nullptr;
+        mappedSize = 0;
+    }
+}
+
+bool CaptureReader::next(CaptureRecord &record) {
+    while (mapping) {
+        if (offset + sizeof(CaptureRecordHeader) <= mappedSize) {
+            CaptureRecordHeader header;
+            std::memcpy(&header, mapping + offset, sizeof(header));
+            bool endMarker = header.timestampNs == 0 && header.length == 0;
+            if (!endMarker && offset + sizeof(header) + header.length <= mappedSize) {
+                record.timestampNs = header.timestampNs;
+                record.direction = static_cast<FrameDirection>(header.direction);
+                record.data = mapping + offset + sizeof(header);
+                record.length = header.length;
+                offset += alignRecord(sizeof(header) + header.length);
+                return true;
+            }
+        }
+        if (!mapSegment(segmentIndex + 1)) {
+            unmapSegment();
+            break;
+        }
+        CaptureFileHeader header;
+        std::memcpy(&header, mapping, sizeof(header));
+        if (header.captureId != captureId) {
+            unmapSegment(); // Left over from another capture.
+        }
+    }
+    return false;
+}
+
+#endif // YUNA_HAS_MMAP
@@ -0,0 +1,92 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#include "PathSelector.h"
+
+#include <algorithm>
+
+using namespace YunaProtocol;
+
+namespace {
+    constexpr double EWMA_WEIGHT = 0.125; // Same smoothing as TCP's SRTT.
+    constexpr double LOSS_PENALTY = 10.0; // A path losing 10% of probes ranks like one twice as slow.
+}
+
+void PathSelector::addPath(uint32_t peerId, size_t transportIndex) {
+    auto &peerPaths = paths[peerId];
+    if (peerPaths.empty()) {
+        peerIds.push_back(peerId);
+    }
+    if (peerPaths.size() <= transportIndex) {
+        peerPaths.resize(transportIndex + 1);
+    }
+    peerPaths[transportIndex].reachable = true;
+}
+
+void PathSelector::onProbeSent(size_t transportIndex) {
+    for (auto &[peerId, peerPaths] : paths) {
+        if (transportIndex >= peerPaths.size() || !peerPaths[transportIndex].reachable) {
+            continue;
+        }
+        PathMetrics &path = peerPaths[transportIndex];
+        if (path.awaitingProbe) {
+            path.lossRate += EWMA_WEIGHT * (1.0 - path.lossRate);
+        }
+        path.awaitingProbe = true;
+    }
+}
+
+void PathSelector::onProbeAnswered(uint32_t peerId, size_t transportIndex, double rttMs) {
+    auto it = paths.find(peerId);
+    if (it == paths.end() || transportIndex >= it->second.size()) {
+        return;
+    }
+    PathMetrics &path = it->second[transportIndex];
+    if (path.awaitingProbe) {
+        path.lossRate -= EWMA_WEIGHT * path.lossRate;
+        path.awaitingProbe = false;
+    }
+    path.smoothedRttMs = path.hasRtt ? path.smoothedRttMs + EWMA_WEIGHT * (rttMs - path.smoothedRttMs) : rttMs;
+    path.hasRtt = true;
+}
+
+double PathSelector::score(const PathMetrics &path) {
+    return path.smoothedRttMs * (1.0 + LOSS_PENALTY * path.lossRate);
+}
+
+void PathSelector::rank(uint32_t peerId, std::vector<size_t> &ranked) const {
+    ranked.clear();
+    auto it = paths.find(peerId);
+    if (it == paths.end()) {
+        return;
+    }
+    const auto &peerPaths = it->second;
+    for (size_t i = 0; i < peerPaths.size(); ++i) {
+        if (peerPaths[i].reachable) {
+            ranked.push_back(i);
+        }
+    }
+    std::stable_sort(ranked.begin(), ranked.end(), [&peerPaths](size_t a, size_t b) {
+        const PathMetrics &left = peerPaths[a];
+        const PathMetrics &right = peerPaths[b];
+        if (left.hasRtt != right.hasRtt) {
+            return left.hasRtt;
+        }
+        return left.hasRtt && score(left) < score(right);
+    });
+}
+
+bool PathSelector::isReachable(uint32_t peerId, size_t transportIndex) const {
+    auto it = paths.find(peerId);
+    return it != paths.end() && transportIndex < it->second.size() && it->second[transportIndex].reachable;
+}
+
+std::vector<PathMetrics> PathSelector::metrics(uint32_t peerId) const {
+    auto it = paths.find(peerId);
+    return it == paths.end() ? std::vector<PathMetrics>{} : it->second;
+}
+
+const std::vector<uint32_t> &PathSelector::peers() const {
+    return peerIds;
+}
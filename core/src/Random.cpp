@@ -0,0 +1,20 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#include "Random.h"
+
+#if defined(ARDUINO_ARCH_ESP8266)
+#include <Arduino.h>
+#else
+#include <random>
+#endif
+
+uint32_t YunaProtocol::randomUint32() {
+#if defined(ARDUINO_ARCH_ESP8266)
+    return ESP.random(); // The hardware random number generator.
+#else
+    std::random_device device;
+    return device();
+#endif
+}
@@ -0,0 +1,73 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#include "RateLimiter.h"
+
+#include <algorithm>
+
+#include "YunaConfig.h"
+#if YUNA_HAS_THREADS
+#include <thread>
+#elif defined(ARDUINO)
+#include <Arduino.h>
+#endif
+
+using namespace YunaProtocol;
+
+TokenBucket::TokenBucket(double ratePerSecond, double burst)
+    : rate(ratePerSecond < 0 ? 0 : ratePerSecond),
+      capacity(burst < 1 ? 1 : burst),
+      tokens(burst < 1 ? 1 : burst),
+      lastRefill(Clock::now()) {
+}
+
+void TokenBucket::refill(Clock::time_point now) {
+    if (now <= lastRefill) {
+        return;
+    }
+    double elapsed = std::chrono::duration<double>(now - lastRefill).count();
+    tokens = std::min(capacity, tokens + elapsed * rate);
+    lastRefill = now;
+}
+
+bool TokenBucket::tryTake(Clock::time_point now) {
+    refill(now);
+    if (tokens >= 1.0) {
+        tokens -= 1.0;
+        return true;
+    }
+    return false;
+}
+
+TokenBucket::Clock::duration TokenBucket::timeUntilToken(Clock::time_point now) {
+    refill(now);
+    if (tokens >= 1.0) {
+        return Clock::duration::zero();
+    }
+    if (rate <= 0) {
+        return Clock::duration::max();
+    }
+    return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>((1.0 - tokens) / rate));
+}
+
+void YunaProtocol::rateLimiterWait(TokenBucket::Clock::duration duration) {
+    if (duration <= TokenBucket::Clock::duration::zero()) {
+        return;
+    }
+#if YUNA_HAS_THREADS
+    std::this_thread::sleep_for(duration);
+#else
+    auto until = TokenBucket::Clock::now() + duration;
+    while (TokenBucket::Clock::now() < until) {
+#if defined(ARDUINO)
+        // Returns to the core on every pass: a wait of a few seconds would otherwise trip the soft watchdog.
+        if (until - TokenBucket::Clock::now() >= std::chrono::milliseconds(1)) {
+            delay(1);
+        } else {
+            yield();
+        }
+#endif
+    }
+#endif
+}
@@ -0,0 +1,132 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#include "ReplayTransport.h"
+
+#if YUNA_HAS_MMAP
+#include <iostream>
+
+namespace YunaProtocol {
+
+    ReplayTransport::ReplayTransport(std::string basePath, double speed, bool replaySentFrames)
+        : reader(std::move(basePath)), speed(speed < 0 ? 0 : speed), replaySentFrames(replaySentFrames) {
+    }
+
+    bool ReplayTransport::initialize() {
+        if (!reader.open()) {
+            std::cerr << "ReplayTransport: no capture segment found." << std::endl;
+            return false;
+        }
+        initialized = true;
+        exhausted = false;
+        hasPending = false;
+        firstTimestampNs = 0;
+        replayed = 0;
+        return true;
+    }
+
+    bool ReplayTransport::send(const Packet &packet) {
+        if (!initialized) return false;
+        std::vector<uint8_t> buffer;
+        if (frameTap && packet.serialize(buffer)) {
+            tapFrame(FrameDirection::Sent, buffer.data(), buffer.size());
+        }
+        return true;
+    }
+
+    bool ReplayTransport::sendTo(uint32_t clientId, const Packet &packet) {
+        if (clients.count(clientId) == 0) return false;
+        return send(packet);
+    }
+
+    bool ReplayTransport::broadcast(const Packet &packet) {
+        return send(packet);
+    }
+
+    void ReplayTransport::loop() {
+        if (!initialized || exhausted) return;
+
+        for (size_t delivered = 0; delivered < maxFramesPerLoop;) {
+            if (!hasPending) {
+                if (!reader.next(pendingRecord)) {
+                    exhausted = true;
+                    return;
+                }
+                if (pendingRecord.direction == FrameDirection::Sent && !replaySentFrames) {
+                    continue;
+                }
+                hasPending = true;
+                if (firstTimestampNs == 0) {
+                    firstTimestampNs = pendingRecord.timestampNs;
+                    replayStart = std::chrono::steady_clock::now();
+                }
+            }
+
+            if (speed > 0) {
+                // Original offset from the first frame, compressed by the replay speed. Records stamped
+                // before the first one (a wall-clock step, or frames appended by another thread) are due at once.
+                auto offsetNs = static_cast<int64_t>(pendingRecord.timestampNs - firstTimestampNs);
+                if (offsetNs < 0) {
+                    offsetNs = 0;
+                }
+                auto due = replayStart + std::chrono::nanoseconds(static_cast<int64_t>(
+                    static_cast<double>(offsetNs) / speed));
+                if (std::chrono::steady_clock::now() < due) {
+                    return;
+                }
+            }
+
+            // The pending record still points into the currently mapped segment.
+            deliver(pendingRecord);
+            hasPending = false;
+            delivered++;
+        }
+    }
+
+    void ReplayTransport::deliver(const CaptureRecord &record) {
+        tapFrame(FrameDirection::Received, record.data, record.length);
+        Packet receivedPacket;
+        DecodeStatus status = receivedPacket.decode(record.data, record.length);
+        if (status != DecodeStatus::Ok) {
+            if (status == DecodeStatus::ChecksumMismatch) {
+                corruptedPackets++;
+            }
+            return;
+        }
+        replayed++;
+        uint32_t sourceId = receivedPacket.header.sourceId; // Copied out of the packed header.
+        if (sourceId == clientID) {
+            return;
+        }
+        bool joining = receivedPacket.header.packetType == DISCOVERY_PEER && (receivedPacket.header.flags & PACKET_FLAG_JOIN);
+        // A known peer that joins again has restarted, as a live transport would report.
+        if (clients.insert(sourceId).second || joining) {
+            notifyPeerDiscovered(sourceId);
+        }
+        // Discovery is handled by the transport, as a live one would; the node never sees it.
+        PacketType type = receivedPacket.header.packetType;
+        if (type != DISCOVERY_PEER && type != DISCOVERY_REPLY && callback) {
+            callback(receivedPacket);
+        }
+    }
+
+    std::vector<uint32_t> ReplayTransport::listConnectedClients() {
+        return {clients.begin(), clients.end()};
+    }
+
+    void ReplayTransport::set_max_frames_per_loop(size_t frames) {
+        this->maxFramesPerLoop = frames == 0 ? 1 : frames;
+    }
+
+    bool ReplayTransport::finished() const {
+        return exhausted;
+    }
+
+    uint64_t ReplayTransport::replayedFrames() const {
+        return replayed;
+    }
+
+} // namespace YunaProtocol
+
+#endif // YUNA_HAS_MMAP
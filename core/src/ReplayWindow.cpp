@@ -0,0 +1,50 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#include "ReplayWindow.h"
+
+using namespace YunaProtocol;
+
+bool ReplayWindow::accept(uint32_t sourceId, uint64_t nonce) {
+    auto session = static_cast<uint32_t>(nonce >> 32);
+    auto counter = static_cast<uint32_t>(nonce);
+    auto [it, created] = windows.try_emplace(sourceId);
+    Window &window = it->second;
+    if (created) {
+        window.session = session;
+        window.highest = counter;
+        window.bitmap = 1;
+        return true;
+    }
+    if (session < window.session) {
+        rejected++; // Sent before the sender's last restart.
+        return false;
+    }
+    if (session > window.session) {
+        // The sender restarted: every older session is out from now on.
+        window.session = session;
+        window.highest = counter;
+        window.bitmap = 1;
+        return true;
+    }
+    // Counters only grow within a session; a wrapping counter carries into the next session.
+    if (counter > window.highest) {
+        uint32_t ahead = counter - window.highest;
+        window.bitmap = ahead >= WINDOW_SIZE ? 1 : (window.bitmap << ahead) | 1;
+        window.highest = counter;
+        return true;
+    }
+    uint32_t behind = window.highest - counter;
+    uint64_t bit = behind < WINDOW_SIZE ? uint64_t{1} << behind : 0;
+    if (bit == 0 || (window.bitmap & bit)) {
+        rejected++; // Replayed, or too old to tell.
+        return false;
+    }
+    window.bitmap |= bit;
+    return true;
+}
+
+uint64_t ReplayWindow::replays() const {
+    return rejected;
+}
@@ -0,0 +1,120 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#include "RetainedCache.h"
+
+#include <cstring>
+
+#include "Packet.h"
+
+using namespace YunaProtocol;
+
+namespace {
+    // Sync entry layout: sourceId, channel name (same width as PacketHeader::channel), length, payload.
+    constexpr size_t SYNC_CHANNEL_SIZE = sizeof(PacketHeader::channel);
+    constexpr size_t SYNC_ENTRY_HEADER = sizeof(uint32_t) + SYNC_CHANNEL_SIZE + sizeof(uint16_t);
+}
+
+RetainedCache::RetainedCache(size_t capacity, size_t maxPayloadSize)
+    : capacity(capacity), maxPayloadSize(maxPayloadSize) {
+}
+
+bool RetainedCache::store(const std::string &channel, uint32_t sourceId, const std::vector<uint8_t> &payload) {
+    if (capacity == 0 || payload.size() > maxPayloadSize) {
+        return false;
+    }
+    auto it = entries.find(channel);
+    if (it == entries.end()) {
+        if (entries.size() >= capacity) {
+            evictOldest();
+        }
+        it = entries.emplace(channel, RetainedEntry{}).first;
+    }
+    it->second.sourceId = sourceId;
+    it->second.payload = payload;
+    it->second.lastUpdate = ++clock;
+    return true;
+}
+
+const RetainedEntry *RetainedCache::find(const std::string &channel) const {
+    auto it = entries.find(channel);
+    return it == entries.end() ? nullptr : &it->second;
+}
+
+void RetainedCache::setCapacity(size_t capacity) {
+    this->capacity = capacity;
+    while (entries.size() > capacity) {
+        evictOldest();
+    }
+}
+
+size_t RetainedCache::size() const {
+    return entries.size();
+}
+
+void RetainedCache::evictOldest() {
+    auto oldest = entries.end();
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if (oldest == entries.end() || it->second.lastUpdate < oldest->second.lastUpdate) {
+            oldest = it;
+        }
+    }
+    if (oldest != entries.end()) {
+        entries.erase(oldest);
+    }
+}
+
+std::vector<std::vector<uint8_t> > RetainedCache::encodeSync(uint32_t sourceId, size_t maxDatagramPayload,
+                                                             const std::function<bool(const std::string &)> &skip) const {
+    std::vector<std::vector<uint8_t> > batches;
+    std::vector<uint8_t> batch;
+    for (const auto &[channel, entry] : entries) {
+        if (entry.sourceId != sourceId || (skip && skip(channel))) {
+            continue;
+        }
+        size_t entrySize = SYNC_ENTRY_HEADER + entry.payload.size();
+        if (!batch.empty() && batch.size() + entrySize > maxDatagramPayload) {
+            batches.push_back(std::move(batch));
+            batch.clear();
+        }
+        size_t offset = batch.size();
+        batch.resize(offset + entrySize);
+        uint16_t length = static_cast<uint16_t>(entry.payload.size());
+        char name[SYNC_CHANNEL_SIZE]{};
+        std::strncpy(name, channel.c_str(), SYNC_CHANNEL_SIZE - 1);
+        std::memcpy(batch.data() + offset, &entry.sourceId, sizeof(uint32_t));
+        std::memcpy(batch.data() + offset + sizeof(uint32_t), name, SYNC_CHANNEL_SIZE);
+        std::memcpy(batch.data() + offset + sizeof(uint32_t) + SYNC_CHANNEL_SIZE, &length, sizeof(uint16_t));
+        if (length > 0) {
+            std::memcpy(batch.data() + offset + SYNC_ENTRY_HEADER, entry.payload.data(), length);
+        }
+    }
+    if (!batch.empty()) {
+        batches.push_back(std::move(batch));
+    }
+    return batches;
+}
+
+bool RetainedCache::decodeSync(const std::vector<uint8_t> &payload,
+                               const std::function<void(const char *, uint32_t, const uint8_t *, uint16_t)> &visitor) {
+    size_t offset = 0;
+    while (offset < payload.size()) {
+        if (payload.size() - offset < SYNC_ENTRY_HEADER) {
+            return false;
+        }
+        uint32_t sourceId;
+        char channel[SYNC_CHANNEL_SIZE];
+        uint16_t length;
+        std::memcpy(&sourceId, payload.data() + offset, sizeof(uint32_t));
+        std::memcpy(channel, payload.data() + offset + sizeof(uint32_t), SYNC_CHANNEL_SIZE);
+        std::memcpy(&length, payload.data() + offset + sizeof(uint32_t) + SYNC_CHANNEL_SIZE, sizeof(uint16_t));
+        channel[SYNC_CHANNEL_SIZE - 1] = '\0';
+        if (payload.size() - offset - SYNC_ENTRY_HEADER < length) {
+            return false;
+        }
+        visitor(channel, sourceId, payload.data() + offset + SYNC_ENTRY_HEADER, length);
+        offset += SYNC_ENTRY_HEADER + length;
+    }
+    return true;
+}
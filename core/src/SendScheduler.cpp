@@ -0,0 +1,87 @@
+//
+// Created by youss on 10/19/2026.
+//
+
+#include "SendScheduler.h"
+
+using namespace YunaProtocol;
+
+SendScheduler::SendScheduler(size_t queueLimit, size_t quantum)
+    : queueLimit(queueLimit), quantum(quantum == 0 ? 1 : quantum) {
+    queues[static_cast<size_t>(PriorityClass::Interactive)].weight = 8;
+    queues[static_cast<size_t>(PriorityClass::Standard)].weight = 4;
+    queues[static_cast<size_t>(PriorityClass::Bulk)].weight = 1;
+}
+
+void SendScheduler::setWeight(PriorityClass priority, uint32_t weight) {
+    queues[static_cast<size_t>(priority)].weight = weight == 0 ? 1 : weight;
+}
+
+size_t SendScheduler::wireSize(const OutgoingPacket &item) {
+    return sizeof(PacketHeader) + item.packet.payload.size();
+}
+
+bool SendScheduler::enqueue(OutgoingPacket item) {
+    ClassQueue &queue = queues[static_cast<size_t>(item.priority)];
+    if (queue.packets.size() >= queueLimit) {
+        queue.stats.dropped++;
+        return false;
+    }
+    queue.packets.push_back(std::move(item));
+    queue.stats.enqueued++;
+    queuedPackets++;
+    return true;
+}
+
+void SendScheduler::take(ClassQueue &queue, OutgoingPacket &item) {
+    item = std::move(queue.packets.front());
+    queue.packets.pop_front();
+    queue.stats.sent++;
+    queuedPackets--;
+}
+
+bool SendScheduler::dequeue(OutgoingPacket &item) {
+    if (queuedPackets == 0) {
+        return false;
+    }
+    ClassQueue &control = queues[static_cast<size_t>(PriorityClass::Control)];
+    if (!control.packets.empty()) {
+        take(control, item);
+        return true;
+    }
+
+    // Deficit round robin over the remaining classes. At least one of them is non-empty,
+    // and every visit to it adds credit, so this terminates.
+    while (true) {
+        ClassQueue &queue = queues[current];
+        if (queue.packets.empty()) {
+            queue.deficit = 0;
+        } else {
+            if (!visitCredited) {
+                queue.deficit += static_cast<size_t>(queue.weight) * quantum;
+                visitCredited = true;
+            }
+            size_t size = wireSize(queue.packets.front());
+            if (size <= queue.deficit) {
+                queue.deficit -= size;
+                take(queue, item);
+                if (queue.packets.empty()) {
+                    queue.deficit = 0;
+                }
+                return true;
+            }
+        }
+        current = current + 1 < PRIORITY_CLASS_COUNT ? current + 1 : 1;
+        visitCredited = false;
+    }
+}
+
+bool SendScheduler::empty() const {
+    return queuedPackets == 0;
+}
+
+SchedulerClassStats SendScheduler::getStats(PriorityClass priority) const {
+    SchedulerClassStats stats = queues[static_cast<size_t>(priority)].stats;
+    stats.queued = queues[static_cast<size_t>(priority)].packets.size();
+    return stats;
+}
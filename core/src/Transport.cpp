@@ -6,4 +6,8 @@
 void  YunaProtocol::YunaTransport::registerDataReceivedCallback(const DataReceivedCallback& callback) {
     this->callback = callback;
 
- }
\ No newline at end of file
+ }
+
+void YunaProtocol::YunaTransport::registerPeerDiscoveredCallback(const PeerDiscoveredCallback& callback) {
+    this->peerDiscoveredCallback = callback;
+}
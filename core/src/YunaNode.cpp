@@ -4,21 +4,65 @@
 
 #include "YunaNode.h"
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <string_view>
+
+#include "Random.h"
+
+namespace {
+    // FNV-1a, used to spread channels over the executor strands.
+    uint32_t hashChannel(std::string_view channel) {
+        uint32_t hash = 2166136261u;
+        for (char c : channel) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    // Channel names fill the whole field when they are 32 characters long, so never rely on a terminator.
+    std::string_view channelView(const YunaProtocol::PacketHeader &header) {
+        size_t length = 0;
+        while (length < sizeof(header.channel) && header.channel[length] != '\0') {
+            length++;
+        }
+        return {header.channel, length};
+    }
+
+    std::string channelName(const YunaProtocol::PacketHeader &header) {
+        return std::string(channelView(header));
+    }
+
+    // Sources silent for this long lose their duplicate window, checked about once a minute.
+    constexpr auto DUPLICATE_IDLE = std::chrono::minutes(5);
+    constexpr auto DUPLICATE_PRUNE_INTERVAL = std::chrono::minutes(1);
+
+    // Marks packets that did not come through a registered transport.
+    constexpr size_t NO_TRANSPORT = std::numeric_limits<size_t>::max();
+
+    uint64_t steadyNowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+}
 
 uint32_t YunaProtocol::YunaNode::getNodeId() const {
     return this->id;
 }
 
-void YunaProtocol::YunaNode:: registerDataCallback(const std::string& channel,DataReceivedCallback callback)  {
-
-    dataCallbacks[channel]= std::move(callback);
+bool YunaProtocol::YunaNode:: registerDataCallback(const std::string& channel,DataReceivedCallback callback)  {
+    return dataCallbacks.add(channel, std::move(callback));
+}
 
+bool YunaProtocol::YunaNode::unregisterDataCallback(const std::string& channel) {
+    return dataCallbacks.remove(channel);
 }
 
-YunaProtocol::YunaNode::YunaNode(uint32_t nodeID): id(nodeID) {
+YunaProtocol::YunaNode::YunaNode(uint32_t nodeID): id(nodeID), lastSequence(randomUint32()) {
     // Initialize the node with a unique ID
     // Additional initialization logic can be added here if needed
 
@@ -26,44 +70,323 @@ YunaProtocol::YunaNode::YunaNode(uint32_t nodeID): id(nodeID) {
 
 YunaProtocol::YunaNode::~YunaNode() = default;
 
-void YunaProtocol::YunaNode::sendData(std::vector<uint8_t> payload, const char channel[32]) {
+void YunaProtocol::YunaNode::sendData(std::vector<uint8_t> payload, const char channel[32], bool retained) {
     Packet packet;
+    packet.header.packetType = DATA;
     packet.header.sourceId = this->id;
     std::strncpy(packet.header.channel, channel, sizeof(packet.header.channel) - 1);
     packet.header.channel[sizeof(packet.header.channel) - 1] = '\0'; // Ensure null termination
     packet.header.payloadLength = static_cast<uint16_t>(payload.size());
+    if (integrityCheck) {
+        packet.header.flags |= PACKET_FLAG_CRC32C;
+    }
+    if (retained) {
+        packet.header.flags |= PACKET_FLAG_RETAINED;
+    }
     packet.payload = std::move(payload);
+    for (bool retry = false;; retry = true) {
+        RateLimiter<std::string>::Clock::duration wait{};
+        {
+            LockGuard lock(sendMutex);
+            if (retained && !retry) {
+                retainedCache.store(packet.header.channel, id, packet.payload);
+            }
+            PriorityClass priority = priorityOf(packet.header.channel);
+            auto verdict = channelLimiter.admit(packet.header.channel, packet, priority, &wait, retry);
+            if (verdict == RateLimiter<std::string>::Verdict::Send) {
+                OutgoingPacket item;
+                item.priority = priority;
+                item.packet = std::move(packet);
+                // Bulk packets wait for the end of loop() so they can be sent as one batch.
+                bool flushNow = !inLoop && item.priority != PriorityClass::Bulk;
+                scheduler.enqueue(std::move(item));
+                if (flushNow) {
+                    flushSendQueue();
+                }
+                return;
+            }
+            if (verdict != RateLimiter<std::string>::Verdict::Wait) {
+                return; // Dropped, or queued until loop() finds a token for it.
+            }
+        }
+        // Blocked: wait for the token without the lock, so loop() and other senders go on, then ask again.
+        rateLimiterWait(wait);
+    }
+}
+
+YunaProtocol::PriorityClass YunaProtocol::YunaNode::priorityOf(const char *channel) const {
+    if (channelPriorities.empty()) {
+        return PriorityClass::Standard;
+    }
+    auto it = channelPriorities.find(channel);
+    return it == channelPriorities.end() ? PriorityClass::Standard : it->second;
+}
+
+void YunaProtocol::YunaNode::flushSendQueue() {
+    OutgoingPacket item;
+    bool batchBulk = !routesPerPeer();
+    for (size_t sent = 0; (sendBudget == 0 || sent < sendBudget) && scheduler.dequeue(item); ++sent) {
+        // Numbered on the way out, so packets held by a limiter or the budget do not arrive far behind.
+        item.packet.header.sequence = allocateSequence();
+        if (batchBulk && item.priority == PriorityClass::Bulk && item.transportIndex == OutgoingPacket::ANY_TRANSPORT) {
+            bulkBatch.push_back(std::move(item.packet));
+            continue;
+        }
+        flushBulkBatch(); // Keep the order the scheduler chose.
+        if (!channelCipher.seal(&item.packet, 1)) {
+            continue; // Never send a keyed channel in the clear.
+        }
+        sendOutgoing(item);
+    }
+    flushBulkBatch();
+}
+
+void YunaProtocol::YunaNode::flushBulkBatch() {
+    if (bulkBatch.empty()) {
+        return;
+    }
+    // Sealed together, so the cipher fills its vector lanes across packets.
+    if (!channelCipher.seal(bulkBatch.data(), bulkBatch.size())) {
+        // Never send a keyed channel in the clear.
+        bulkBatch.erase(std::remove_if(bulkBatch.begin(), bulkBatch.end(),
+                                       [this](const Packet &packet) { return channelCipher.needsSealing(packet); }),
+                        bulkBatch.end());
+    }
     for (auto &transport : transports) {
-        transport->send(packet);
+        transport->setTrafficClass(PriorityClass::Bulk);
+        transport->sendBatch(bulkBatch.data(), bulkBatch.size());
+    }
+    bulkBatch.clear();
+}
 
+void YunaProtocol::YunaNode::sendOutgoing(const OutgoingPacket& item) {
+    if (item.transportIndex == OutgoingPacket::ANY_TRANSPORT) {
+        transmit(item.packet, item.priority);
+        return;
     }
+    YunaTransport &transport = *transports[item.transportIndex];
+    transport.setTrafficClass(item.priority);
+    if (item.unicast) {
+        transport.sendTo(item.peerId, item.packet);
+    } else {
+        transport.send(item.packet);
+    }
+}
 
+uint32_t YunaProtocol::YunaNode::allocateSequence() {
+    // 0 means unsequenced, so skip it on wrap-around.
+    uint32_t sequence = ++lastSequence;
+    if (sequence == 0) {
+        sequence = ++lastSequence;
+    }
+    return sequence;
+}
 
+bool YunaProtocol::YunaNode::routesPerPeer() const {
+    return peerLimiter.hasLimits() || (transports.size() > 1 && multipathMode == MultipathMode::BestPath);
+}
+
+void YunaProtocol::YunaNode::transmit(const Packet& packet, PriorityClass priority) {
+    if (!routesPerPeer()) {
+        // One send() per transport reaches all of its clients.
+        for (auto &transport : transports) {
+            transport->setTrafficClass(priority);
+            transport->send(packet);
+
+        }
+        return;
+    }
+    for (uint32_t peerId : paths.peers()) {
+        if (peerLimiter.admit(peerId, packet, priority) == RateLimiter<uint32_t>::Verdict::Send) {
+            sendToPeer(peerId, packet, priority);
+        }
+    }
+}
+
+void YunaProtocol::YunaNode::sendToPeer(uint32_t peerId, const Packet& packet, PriorityClass priority) {
+    // Set per send: packets released later by the peer limiter come after others of another class.
+    if (multipathMode == MultipathMode::Redundant) {
+        for (size_t i = 0; i < transports.size(); ++i) {
+            if (paths.isReachable(peerId, i)) {
+                transports[i]->setTrafficClass(priority);
+                transports[i]->sendTo(peerId, packet);
+            }
+        }
+        return;
+    }
+    paths.rank(peerId, rankedPaths);
+    for (size_t index : rankedPaths) {
+        transports[index]->setTrafficClass(priority);
+        if (transports[index]->sendTo(peerId, packet)) {
+            return; // Fall back to the next best path only when sending fails.
+        }
+    }
 }
 
 void YunaProtocol::YunaNode::addTransport(std::unique_ptr<YunaTransport> transport) {
     transport->setClientId(id);
-    transport->registerDataReceivedCallback(    [this](const YunaProtocol::Packet& packet) {
-        this->handleDataPacket(packet);
+    transport->setFrameTap(frameTap);
+    size_t transportIndex = transports.size();
+    transport->registerDataReceivedCallback(    [this, transportIndex](const YunaProtocol::Packet& packet) {
+        // Stamped alongside the packet rather than in a copy of it.
+        uint64_t decodedNs = packet.timestamps.decodedNs;
+        if (this->latencyTracking && decodedNs == 0) {
+            decodedNs = wallClockNs();
+        }
+        this->handleIncoming(transportIndex, packet, decodedNs);
     });
+    transport->registerPeerDiscoveredCallback([this, transportIndex](uint32_t peerId) {
+        LockGuard lock(this->sendMutex);
+        this->paths.addPath(peerId, transportIndex);
+        this->sendRetainedSync(transportIndex, peerId);
+    });
+    LockGuard lock(sendMutex);
+    for (uint32_t peerId : transport->listConnectedClients()) {
+        paths.addPath(peerId, transportIndex);
+    }
     transports.push_back(std::move(transport));
 
 }
 
-void YunaProtocol::YunaNode::loop() const {
+void YunaProtocol::YunaNode::loop() {
+    inLoop = true;
     for (auto &transport : transports) {
         transport->loop();
     }
+    dataCallbacks.reclaim();
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastDuplicatePrune >= DUPLICATE_PRUNE_INTERVAL) {
+        lastDuplicatePrune = now;
+        LockGuard lock(duplicateMutex);
+        duplicateFilter.prune(now - DUPLICATE_IDLE);
+    }
+    LockGuard lock(sendMutex);
+    if (transports.size() > 1 && std::chrono::steady_clock::now() - lastProbe >= probeInterval) {
+        probePaths();
+    }
+    // Release packets the DropOldest policy held back.
+    channelLimiter.drain([this](const std::string&, const Packet& packet, PriorityClass priority) {
+        OutgoingPacket item;
+        item.priority = priority;
+        item.packet = packet;
+        scheduler.enqueue(std::move(item));
+    });
+    inLoop = false;
+    flushSendQueue();
+    peerLimiter.drain([this](uint32_t peerId, const Packet& packet, PriorityClass priority) {
+        sendToPeer(peerId, packet, priority);
+    });
+}
+
+void YunaProtocol::YunaNode::probePaths() {
+    lastProbe = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < transports.size(); ++i) {
+        Packet probe;
+        probe.header.packetType = PING;
+        probe.header.sourceId = id;
+        uint64_t sentAt = steadyNowNs();
+        probe.payload.resize(sizeof(sentAt));
+        std::memcpy(probe.payload.data(), &sentAt, sizeof(sentAt));
+        probe.header.payloadLength = static_cast<uint16_t>(probe.payload.size());
+        paths.onProbeSent(i);
+        OutgoingPacket item;
+        item.priority = PriorityClass::Control;
+        item.transportIndex = i;
+        item.packet = std::move(probe);
+        scheduler.enqueue(std::move(item));
+    }
+}
+
+void YunaProtocol::YunaNode::handleDataPacket(const Packet& packet) {
+    handleIncoming(NO_TRANSPORT, packet, packet.timestamps.decodedNs);
 }
 
-void YunaProtocol::YunaNode::handleDataPacket(const Packet& packet) const {
-    std::string channel(packet.header.channel);
-    auto it = dataCallbacks.find(channel);
-    if (it != dataCallbacks.end()) {
-        it->second(packet); // Call the registered callback with the packet
+void YunaProtocol::YunaNode::handleIncoming(size_t transportIndex, const Packet& packet, uint64_t decodedNs) {
+    if (packet.header.flags & PACKET_FLAG_ENCRYPTED) {
+        Packet plain;
+        if (channelCipher.open(packet, plain)) {
+            handlePlaintext(transportIndex, plain, decodedNs);
+        }
+        return; // Otherwise the key is unknown, or the packet is not authentic or replayed.
+    }
+    if (packet.header.packetType == DATA && !channelCipher.acceptPlaintext(channelView(packet.header))) {
+        return;
     }
+    handlePlaintext(transportIndex, packet, decodedNs);
+}
 
+void YunaProtocol::YunaNode::handlePlaintext(size_t transportIndex, const Packet& packet, uint64_t decodedNs) {
+    bool carriesData = packet.header.packetType == DATA || packet.header.packetType == RETAINED_SYNC;
+    bool protectedPacket = (packet.header.flags & (PACKET_FLAG_CRC32C | PACKET_FLAG_ENCRYPTED)) != 0;
+    if (integrityCheck && carriesData && !protectedPacket) {
+        return;
+    }
+    // A peer reachable over several transports may deliver the same packet more than once.
+    {
+        LockGuard lock(duplicateMutex);
+        if (!duplicateFilter.accept(packet.header.sourceId, packet.header.sequence)) {
+            return;
+        }
+    }
+    if (packet.header.packetType == PING) {
+        // Echo the probe back on the transport it came from.
+        if (transportIndex != NO_TRANSPORT) {
+            Packet reply;
+            reply.header.packetType = ACKNOWLEDGEMENT;
+            reply.header.sourceId = id;
+            reply.header.payloadLength = packet.header.payloadLength;
+            reply.payload = packet.payload;
+            OutgoingPacket item;
+            item.priority = PriorityClass::Control;
+            item.transportIndex = transportIndex;
+            item.unicast = true;
+            item.peerId = packet.header.sourceId;
+            item.packet = std::move(reply);
+            LockGuard lock(sendMutex);
+            scheduler.enqueue(std::move(item));
+        }
+        return;
+    }
+    if (packet.header.packetType == ACKNOWLEDGEMENT) {
+        uint64_t sentAt;
+        if (transportIndex != NO_TRANSPORT && packet.payload.size() == sizeof(sentAt)) {
+            std::memcpy(&sentAt, packet.payload.data(), sizeof(sentAt));
+            double rttMs = static_cast<double>(steadyNowNs() - sentAt) / 1e6;
+            LockGuard lock(sendMutex);
+            paths.onProbeAnswered(packet.header.sourceId, transportIndex, rttMs);
+        }
+        return;
+    }
+    if (packet.header.packetType == RETAINED_SYNC) {
+        handleRetainedSync(packet, decodedNs);
+        return;
+    }
+    if (packet.header.packetType == DATA && (packet.header.flags & PACKET_FLAG_RETAINED)) {
+        LockGuard lock(sendMutex);
+        retainedCache.store(channelName(packet.header), packet.header.sourceId, packet.payload);
+    }
+    dispatchToCallback(packet, decodedNs);
+}
 
+void YunaProtocol::YunaNode::dispatchToCallback(const Packet& packet, uint64_t decodedNs) const {
+    if (packet.header.packetType != DATA) {
+        return; // Anything else has no channel, and would reach every "#" subscriber.
+    }
+    std::string_view channel = channelView(packet.header);
+    dataCallbacks.forEachMatch(channel, [this, &packet, channel, decodedNs](const CallbackRegistry::SharedCallback& callback) {
+#if YUNA_HAS_THREADS
+        if (std::shared_ptr<HandlerExecutor> pool = std::atomic_load(&executor)) {
+            uint32_t key = executorOrdering == OrderingKey::Source ? packet.header.sourceId : hashChannel(channel);
+            Packet copy = packet; // The task owns a copy anyway, so it carries the stamp.
+            copy.timestamps.decodedNs = decodedNs;
+            pool->submit(key, [this, callback, copy = std::move(copy)]() {
+                runCallback(*callback, copy, copy.timestamps.decodedNs);
+            });
+            return;
+        }
+#endif
+        runCallback(*callback, packet, decodedNs); // Call the registered callback with the packet
+    });
 }
 
 std::vector<uint32_t>  YunaProtocol::YunaNode::listConnectedClients() {
@@ -75,3 +398,250 @@ std::vector<uint32_t>  YunaProtocol::YunaNode::listConnectedClients() {
     return connectedClients;
 
 }
+
+void YunaProtocol::YunaNode::runCallback(const DataReceivedCallback& callback, const Packet& packet,
+                                         uint64_t decodedNs) const {
+    if (!latencyTracking) {
+        callback(packet);
+        return;
+    }
+    // The first two stages compare with the kernel's wall-clock stamp, so they use the wall clock
+    // and skip readings that went backwards; the handler's own duration uses the steady clock.
+    uint64_t startedAt = wallClockNs();
+    uint64_t kernelRxNs = packet.timestamps.kernelRxNs;
+    if (kernelRxNs != 0 && decodedNs >= kernelRxNs) {
+        kernelToDecodeLatency.record(decodedNs - kernelRxNs);
+    }
+    if (decodedNs != 0 && startedAt >= decodedNs) {
+        decodeToHandlerLatency.record(startedAt - decodedNs);
+    }
+    uint64_t handlerStart = steadyNowNs();
+    callback(packet);
+    handlerLatency.record(steadyNowNs() - handlerStart);
+}
+
+void YunaProtocol::YunaNode::handleRetainedSync(const Packet& packet, uint64_t decodedNs) {
+    RetainedCache::decodeSync(packet.payload, [this, &packet, decodedNs](const char *channel, uint32_t sourceId,
+                                                                         const uint8_t *data, uint16_t length) {
+        if (!channelCipher.acceptPlaintext(channel)) {
+            return;
+        }
+        // Replay every entry as the retained DATA packet its publisher originally sent.
+        Packet retainedPacket;
+        retainedPacket.header.packetType = DATA;
+        retainedPacket.header.sourceId = sourceId;
+        retainedPacket.header.flags = static_cast<uint8_t>(PACKET_FLAG_RETAINED | (packet.header.flags & PACKET_FLAG_CRC32C));
+        std::strncpy(retainedPacket.header.channel, channel, sizeof(retainedPacket.header.channel) - 1);
+        retainedPacket.header.payloadLength = length;
+        retainedPacket.payload.assign(data, data + length);
+        {
+            LockGuard lock(sendMutex);
+            retainedCache.store(channel, sourceId, retainedPacket.payload);
+        }
+        dispatchToCallback(retainedPacket, decodedNs);
+    });
+}
+
+void YunaProtocol::YunaNode::sendRetainedSync(size_t transportIndex, uint32_t peerId) {
+    auto encrypted = [this](const std::string& channel) { return channelCipher.hasKey(channel); };
+    for (auto &batch : retainedCache.encodeSync(id, YUNA_RETAINED_MAX_PAYLOAD, encrypted)) {
+        Packet packet;
+        packet.header.packetType = RETAINED_SYNC;
+        packet.header.sourceId = id;
+        packet.header.payloadLength = static_cast<uint16_t>(batch.size());
+        if (integrityCheck) {
+            packet.header.flags |= PACKET_FLAG_CRC32C;
+        }
+        packet.payload = std::move(batch);
+        OutgoingPacket item;
+        item.priority = PriorityClass::Control;
+        item.transportIndex = transportIndex;
+        item.unicast = true;
+        item.peerId = peerId;
+        item.packet = std::move(packet);
+        scheduler.enqueue(std::move(item));
+    }
+    // Values of encrypted channels stay out of the batch and go as DATA packets, sealed like any other.
+    for (const std::string& channel : channelCipher.channels()) {
+        const RetainedEntry *entry = retainedCache.find(channel);
+        if (!entry || entry->sourceId != id) {
+            continue;
+        }
+        Packet packet;
+        packet.header.packetType = DATA;
+        packet.header.sourceId = id;
+        packet.header.flags = PACKET_FLAG_RETAINED;
+        if (integrityCheck) {
+            packet.header.flags |= PACKET_FLAG_CRC32C;
+        }
+        std::strncpy(packet.header.channel, channel.c_str(), sizeof(packet.header.channel) - 1);
+        packet.header.payloadLength = static_cast<uint16_t>(entry->payload.size());
+        packet.payload = entry->payload;
+        OutgoingPacket item;
+        item.priority = PriorityClass::Control;
+        item.transportIndex = transportIndex;
+        item.unicast = true;
+        item.peerId = peerId;
+        item.packet = std::move(packet);
+        scheduler.enqueue(std::move(item));
+    }
+}
+
+void YunaProtocol::YunaNode::setRetainedCacheCapacity(size_t channels) {
+    LockGuard lock(sendMutex);
+    retainedCache.setCapacity(channels);
+}
+
+std::optional<std::vector<uint8_t>> YunaProtocol::YunaNode::getRetainedValue(const std::string& channel) const {
+    LockGuard lock(sendMutex);
+    const RetainedEntry *entry = retainedCache.find(channel);
+    if (!entry) {
+        return std::nullopt;
+    }
+    return entry->payload;
+}
+
+void YunaProtocol::YunaNode::setChannelRateLimit(const std::string& channel, const RateLimit& limit) {
+    LockGuard lock(sendMutex);
+    channelLimiter.setLimit(channel, limit);
+}
+
+void YunaProtocol::YunaNode::clearChannelRateLimit(const std::string& channel) {
+    LockGuard lock(sendMutex);
+    channelLimiter.clearLimit(channel);
+}
+
+void YunaProtocol::YunaNode::setPeerRateLimit(uint32_t peerId, const RateLimit& limit) {
+    LockGuard lock(sendMutex);
+    peerLimiter.setLimit(peerId, limit);
+}
+
+void YunaProtocol::YunaNode::clearPeerRateLimit(uint32_t peerId) {
+    LockGuard lock(sendMutex);
+    peerLimiter.clearLimit(peerId);
+}
+
+YunaProtocol::RateLimitStats YunaProtocol::YunaNode::getChannelRateLimitStats(const std::string& channel) const {
+    LockGuard lock(sendMutex);
+    return channelLimiter.getStats(channel);
+}
+
+YunaProtocol::RateLimitStats YunaProtocol::YunaNode::getPeerRateLimitStats(uint32_t peerId) const {
+    LockGuard lock(sendMutex);
+    return peerLimiter.getStats(peerId);
+}
+
+void YunaProtocol::YunaNode::setMultipathMode(MultipathMode mode) {
+    LockGuard lock(sendMutex);
+    multipathMode = mode;
+}
+
+void YunaProtocol::YunaNode::setPathProbeInterval(std::chrono::milliseconds interval) {
+    probeInterval = interval;
+}
+
+std::vector<YunaProtocol::PathMetrics> YunaProtocol::YunaNode::getPathMetrics(uint32_t peerId) const {
+    LockGuard lock(sendMutex);
+    return paths.metrics(peerId);
+}
+
+uint64_t YunaProtocol::YunaNode::getDuplicateCount() const {
+    return duplicateFilter.duplicates();
+}
+
+void YunaProtocol::YunaNode::setChannelPriority(const std::string& channel, PriorityClass priority) {
+    LockGuard lock(sendMutex);
+    channelPriorities[channel] = priority;
+}
+
+void YunaProtocol::YunaNode::setPriorityWeight(PriorityClass priority, uint32_t weight) {
+    LockGuard lock(sendMutex);
+    scheduler.setWeight(priority, weight);
+}
+
+void YunaProtocol::YunaNode::setSendBudget(size_t packetsPerFlush) {
+    LockGuard lock(sendMutex);
+    sendBudget = packetsPerFlush;
+}
+
+YunaProtocol::SchedulerClassStats YunaProtocol::YunaNode::getSchedulerStats(PriorityClass priority) const {
+    LockGuard lock(sendMutex);
+    return scheduler.getStats(priority);
+}
+
+void YunaProtocol::YunaNode::enableLatencyTracking(bool enabled) {
+    latencyTracking = enabled;
+}
+
+YunaProtocol::LatencyStats YunaProtocol::YunaNode::getLatencyStats() const {
+    LatencyStats stats;
+    stats.kernelToDecode = kernelToDecodeLatency.snapshot();
+    stats.decodeToHandler = decodeToHandlerLatency.snapshot();
+    stats.handler = handlerLatency.snapshot();
+    return stats;
+}
+
+void YunaProtocol::YunaNode::resetLatencyStats() {
+    kernelToDecodeLatency.reset();
+    decodeToHandlerLatency.reset();
+    handlerLatency.reset();
+}
+
+void YunaProtocol::YunaNode::setChannelKey(const std::string& channel, const uint8_t *key) {
+    channelCipher.setKey(channel, key);
+}
+
+void YunaProtocol::YunaNode::setEncryptionSession(uint32_t session) {
+    channelCipher.setSession(session);
+}
+
+bool YunaProtocol::YunaNode::clearChannelKey(const std::string& channel) {
+    return channelCipher.clearKey(channel);
+}
+
+YunaProtocol::EncryptionStats YunaProtocol::YunaNode::getEncryptionStats() const {
+    return channelCipher.getStats();
+}
+
+void YunaProtocol::YunaNode::enableIntegrityCheck(bool enabled) {
+    integrityCheck = enabled;
+}
+
+uint64_t YunaProtocol::YunaNode::getCorruptedPacketCount() const {
+    uint64_t total = 0;
+    for (const auto &transport : transports) {
+        total += transport->corruptedPackets;
+    }
+    return total;
+}
+
+void YunaProtocol::YunaNode::setFrameTap(FrameTap *tap) {
+    frameTap = tap;
+    for (auto &transport : transports) {
+        transport->setFrameTap(tap);
+    }
+}
+
+#if YUNA_HAS_THREADS
+void YunaProtocol::YunaNode::enableHandlerExecutor(size_t threadCount, OrderingKey ordering,
+                                                   const std::vector<std::string>& dedicatedChannels) {
+    std::shared_ptr<HandlerExecutor> pool;
+    if (threadCount > 0) {
+        std::vector<uint32_t> dedicatedKeys;
+        if (ordering == OrderingKey::Channel) {
+            for (const std::string &channel : dedicatedChannels) {
+                dedicatedKeys.push_back(hashChannel(channel));
+            }
+        }
+        pool = std::make_shared<HandlerExecutor>(threadCount, 64, std::move(dedicatedKeys));
+    }
+    executorOrdering = ordering;
+    // The previous pool is drained and joined here, or by the dispatch still holding it.
+    std::atomic_store(&executor, std::move(pool));
+}
+
+YunaProtocol::ExecutorStats YunaProtocol::YunaNode::getExecutorStats() const {
+    std::shared_ptr<HandlerExecutor> pool = std::atomic_load(&executor);
+    return pool ? pool->getStats() : ExecutorStats{};
+}
+#endif
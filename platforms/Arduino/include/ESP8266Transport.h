@@ -5,10 +5,15 @@
 #ifndef ESP8266TRANSPORT_H
 #define ESP8266TRANSPORT_H
 
+#include "Discovery.h"
+#include "PeerTable.h"
 #include "Transport.h"
+#include "YunaConfig.h"
 #include <ESP8266WiFi.h>
 #include <WiFiUdp.h>
-#include <map>
+
+// Largest datagram received: a header, YUNA_MAX_PAYLOAD bytes of payload and the checksum trailer.
+#define ESP8266_MAX_DATAGRAM (sizeof(YunaProtocol::PacketHeader) + YUNA_MAX_PAYLOAD + YunaProtocol::PACKET_CHECKSUM_SIZE)
 
 namespace YunaProtocol {
 
@@ -18,6 +23,11 @@ namespace YunaProtocol {
      *
      * This class handles network communication over Wi-Fi, including broadcasting for
      * peer discovery and sending/receiving data packets.
+     *
+     * All of its storage is allocated with the object: up to YUNA_MAX_PEERS peers and one receive
+     * buffer for payloads of up to YUNA_MAX_PAYLOAD bytes, so with a StaticNode the footprint is
+     * known at link time and the heap stays untouched once running. Only listConnectedClients()
+     * and an attached frame tap allocate.
      */
     class ESP8266Transport : public YunaTransport {
     private:
@@ -27,8 +37,27 @@ namespace YunaProtocol {
         bool initialized;
         unsigned long lastDiscoveryBroadcast; // Timestamp of the last discovery broadcast
 
-        // A map to store discovered clients, mapping their client ID to their IP address.
-        std::map<uint32_t, IPAddress> clients;
+        // Discovered clients, mapping their client ID to their IP address.
+        PeerTable<IPAddress, YUNA_MAX_PEERS> clients;
+        bool peerTableFullReported = false;
+
+        // Received datagrams are decoded in place, so no buffer is allocated per packet.
+        uint8_t receiveBuffer[ESP8266_MAX_DATAGRAM];
+
+        // Discovery burst sent after initialize().
+        JoinSchedule joinSchedule;
+
+        void broadcastDiscoveryIfDue();
+
+        void answerJoin(uint32_t joinerId);
+
+        void addClient(uint32_t clientId, const IPAddress& address);
+
+        void addListedPeers(const PacketView& reply);
+
+        bool receiveDatagram(PacketView& packet);
+
+        bool writeDatagram(const IPAddress& address, const PacketView& packet);
 
     public:
         /**
@@ -46,7 +75,8 @@ namespace YunaProtocol {
 
         /**
          * @brief Initializes the transport layer. Must be called before any other operation.
-         * It starts listening for UDP packets on the specified port.
+         * It starts listening for UDP packets on the specified port. The next loop() calls then
+         * send a short burst of joins that running peers answer with the peers they know.
          */
         bool initialize() override;
 
@@ -56,6 +86,24 @@ namespace YunaProtocol {
          */
         void loop() override;
 
+        /**
+         * @brief Does the work of loop(), handing received packets to a sink instead of the data callback.
+         *
+         * The sink is called with a view into the receive buffer, valid for the duration of the call.
+         * Being a template, the whole receive path can be inlined into the caller (see StaticNode).
+         * @param sink Any callable taking a const PacketView&.
+         */
+        template <typename Sink>
+        void poll(Sink& sink) {
+            if (!initialized) return;
+            broadcastDiscoveryIfDue();
+
+            PacketView packet;
+            if (receiveDatagram(packet)) {
+                sink(packet);
+            }
+        }
+
         /**
          * @brief Sends a packet to all clients on the network (broadcast).
          * @param packet The packet to send.
@@ -63,6 +111,21 @@ namespace YunaProtocol {
          */
         bool send(const Packet& packet) override;
 
+        /**
+         * @brief Sends a packet view to every known client, without the virtual call or a serialization buffer.
+         */
+        bool send(const PacketView& packet);
+
+        /**
+         * @brief Sends a packet to a single known client.
+         * @param clientId The destination client ID.
+         * @param packet The packet to send.
+         * @return True if the packet was sent, false if the client is unknown or an error occurred.
+         */
+        bool sendTo(uint32_t clientId, const Packet& packet) override;
+
+        bool sendTo(uint32_t clientId, const PacketView& packet);
+
         /**
          * @brief Broadcasts a packet to all devices on the network.
          * @param packet The packet to broadcast.
@@ -70,6 +133,8 @@ namespace YunaProtocol {
          */
         bool broadcast(const Packet& packet) override;
 
+        bool broadcast(const PacketView& packet);
+
         /**
          * @brief Retrieves a list of all discovered client IDs.
          * @return A vector containing the unique IDs of all connected clients.
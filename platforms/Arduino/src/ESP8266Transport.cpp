@@ -3,6 +3,7 @@
 //
 
 #include "ESP8266Transport.h"
+#include <algorithm>
 
 // Define a constant for the discovery broadcast interval (in milliseconds)
 #define DISCOVERY_INTERVAL 5000
@@ -38,79 +39,191 @@ namespace YunaProtocol {
             return false;
         }
 
+        // 3. Ask running peers for the peers they know instead of waiting for the discovery cycle.
+        joinSchedule.start(millis(), clientID ^ ESP.getChipId() ^ micros());
+
         initialized = true;
         Serial.printf("ESP8266Transport initialized successfully on port %d.\n", listeningPort);
         return true;
     }
 
     void ESP8266Transport::loop() {
-        if (!initialized) return;
+        auto forward = [this](const PacketView& packet) {
+            if (callback) {
+                callback(packet.toPacket());
+            }
+        };
+        poll(forward);
+    }
 
+    void ESP8266Transport::broadcastDiscoveryIfDue() {
         // 1. Periodically broadcast a discovery packet to find other peers.
-        if (millis() - lastDiscoveryBroadcast > DISCOVERY_INTERVAL) {
+        bool joining = joinSchedule.due(millis());
+        if (joining || millis() - lastDiscoveryBroadcast > DISCOVERY_INTERVAL) {
             lastDiscoveryBroadcast = millis(); // Reset the timer
 
-            Packet discoveryPacket;
-            discoveryPacket.header.protocolVersion = 1;
+            PacketView discoveryPacket;
+            discoveryPacket.header.protocolVersion = PROTOCOL_VERSION;
             discoveryPacket.header.packetType = DISCOVERY_PEER;
             discoveryPacket.header.sourceId = clientID;
             discoveryPacket.header.payloadLength = 0;
-            discoveryPacket.header.channelPassword = 0;
+            discoveryPacket.header.nonce = 0;
+            if (joining) {
+                discoveryPacket.header.flags |= PACKET_FLAG_JOIN; // Peers reply with the peers they know
+            }
 
+            setTrafficClass(PriorityClass::Control); // Not the class of whatever data went out last.
             if (!broadcast(discoveryPacket)) {
                 Serial.println("Error: Failed to broadcast discovery packet.");
             }
         }
+    }
 
+    bool ESP8266Transport::receiveDatagram(PacketView& packet) {
         // 2. Check for and process incoming UDP packets.
         int packetSize = udp.parsePacket();
-        if (packetSize > 0) {
-            // A packet has been received.
-            std::vector<uint8_t> buffer(packetSize);
-            int bytesRead = udp.read(buffer.data(), packetSize);
-
-            if (bytesRead > 0) {
-                Packet receivedPacket;
-                if (receivedPacket.deserialize(buffer.data(), bytesRead)) {
-                    // Ignore packets sent by ourselves.
-                    uint32_t alignedSourceId = receivedPacket.header.sourceId;
-                    if (alignedSourceId == clientID) {
-                        return;
-                    }
-
-                    // Handle peer discovery and client list management.
-                    if (receivedPacket.header.packetType == DISCOVERY_PEER || clients.find(alignedSourceId) == clients.end()) {
-                        IPAddress remoteIp = udp.remoteIP();
-                        if (clients.find(alignedSourceId) == clients.end()) {
-                            Serial.printf("New client discovered with ID: %u at %s\n", alignedSourceId, remoteIp.toString().c_str());
-
-                            clients.emplace(alignedSourceId, remoteIp);
-                        }
-                    }
-
-                    // For any packet that isn't for discovery, pass it to the callback.
-                    if (receivedPacket.header.packetType != DISCOVERY_PEER) {
-                        if (callback) {
-                            callback(receivedPacket);
-                        }
-                    }
-                } else {
-                    Serial.printf("Error: Failed to deserialize packet of size %d\n", bytesRead);
+        if (packetSize <= 0) {
+            return false;
+        }
+        if (static_cast<size_t>(packetSize) > ESP8266_MAX_DATAGRAM) {
+            Serial.printf("Error: Dropped oversized packet of size %d\n", packetSize);
+            udp.flush();
+            return false;
+        }
+
+        // A packet has been received.
+        int bytesRead = udp.read(receiveBuffer, packetSize);
+        if (bytesRead <= 0) {
+            return false;
+        }
+        tapFrame(FrameDirection::Received, receiveBuffer, bytesRead);
+        DecodeStatus status = packet.decode(receiveBuffer, bytesRead);
+        if (status == DecodeStatus::Ok) {
+            // Ignore packets sent by ourselves.
+            uint32_t alignedSourceId = packet.header.sourceId;
+            if (alignedSourceId == clientID) {
+                return false;
+            }
+
+            // Handle peer discovery and client list management.
+            bool joining = packet.header.packetType == DISCOVERY_PEER && (packet.header.flags & PACKET_FLAG_JOIN);
+            if (IPAddress *known = clients.find(alignedSourceId)) {
+                if (joining) {
+                    // A known peer that joins again has restarted, possibly at another address.
+                    *known = udp.remoteIP();
+                    notifyPeerDiscovered(alignedSourceId);
                 }
+            } else {
+                addClient(alignedSourceId, udp.remoteIP());
             }
+            if (joining) {
+                answerJoin(alignedSourceId);
+            } else if (packet.header.packetType == DISCOVERY_REPLY) {
+                addListedPeers(packet);
+                return false;
+            }
+
+            // For any packet that isn't for discovery, pass it on.
+            return packet.header.packetType != DISCOVERY_PEER;
         }
+        if (status == DecodeStatus::ChecksumMismatch) {
+            corruptedPackets++;
+            Serial.printf("Error: Dropped corrupted packet of size %d\n", bytesRead);
+        } else {
+            Serial.printf("Error: Failed to deserialize packet of size %d\n", bytesRead);
+        }
+        return false;
     }
 
-    bool ESP8266Transport::send(const Packet& packet) {
-        if (!initialized) return false;
+    void ESP8266Transport::answerJoin(uint32_t joinerId) {
+        // The join has been handled, so its receive buffer holds the list; every peer listens on the broadcast port.
+        uint8_t *entries = receiveBuffer;
+        size_t size = 0;
+        // Bounded by the receive buffer too, in case YUNA_MAX_PAYLOAD is configured below a full reply.
+        const size_t maxSize = std::min(MAX_PEERS_PER_REPLY, static_cast<size_t>(YUNA_MAX_PAYLOAD) / PEER_ENTRY_SIZE) * PEER_ENTRY_SIZE;
+        for (const auto& client : clients) {
+            if (client.id == joinerId) continue;
+            if (size == maxSize) break;
+            const IPAddress& address = client.address;
+            PeerAddress peer;
+            peer.clientId = client.id;
+            peer.ipv4 = static_cast<uint32_t>(address[0]) << 24 | static_cast<uint32_t>(address[1]) << 16 |
+                        static_cast<uint32_t>(address[2]) << 8 | address[3];
+            peer.port = static_cast<uint16_t>(broadcastPort);
+            writePeerEntry(peer, entries + size);
+            size += PEER_ENTRY_SIZE;
+        }
+
+        PacketView reply;
+        reply.header.packetType = DISCOVERY_REPLY;
+        reply.header.sourceId = clientID;
+        reply.header.payloadLength = static_cast<uint16_t>(size);
+        reply.payload = entries;
+        setTrafficClass(PriorityClass::Control);
+        sendTo(joinerId, reply);
+    }
+
+    void ESP8266Transport::addListedPeers(const PacketView& reply) {
+        joinSchedule.onReply();
+        for (size_t offset = 0; offset + PEER_ENTRY_SIZE <= reply.header.payloadLength; offset += PEER_ENTRY_SIZE) {
+            PeerAddress peer = readPeerEntry(reply.payload + offset);
+            if (peer.clientId == clientID || clients.find(peer.clientId)) continue;
+            IPAddress peerIp(static_cast<uint8_t>(peer.ipv4 >> 24), static_cast<uint8_t>(peer.ipv4 >> 16),
+                             static_cast<uint8_t>(peer.ipv4 >> 8), static_cast<uint8_t>(peer.ipv4));
+            addClient(peer.clientId, peerIp);
+        }
+    }
 
+    void ESP8266Transport::addClient(uint32_t clientId, const IPAddress& address) {
+        if (!clients.insert(clientId, address)) {
+            // Reported once; the table keeps the peers it has and later ones are heard but never sent to.
+            if (!peerTableFullReported) {
+                Serial.printf("Warning: Peer table full (%u peers), ignoring client %u\n",
+                              static_cast<unsigned>(clients.capacity()), clientId);
+                peerTableFullReported = true;
+            }
+            return;
+        }
+        Serial.printf("New client discovered with ID: %u at %s\n", clientId, address.toString().c_str());
+        notifyPeerDiscovered(clientId);
+    }
 
-        // Serialize the packet into a buffer.
-        std::vector<uint8_t> buffer;
-        if (!packet.serialize(buffer)) {
-            Serial.println("Failed to serialize packet for sending.");
+    bool ESP8266Transport::writeDatagram(const IPAddress& address, const PacketView& packet) {
+        if (!udp.beginPacket(address, broadcastPort)) {
             return false;
         }
+        // Written piece by piece into the UDP buffer, so the packet is never serialized on its own.
+        udp.write(reinterpret_cast<const uint8_t*>(&packet.header), sizeof(PacketHeader));
+        if (packet.header.payloadLength > 0) {
+            udp.write(packet.payload, packet.header.payloadLength);
+        }
+        if (packet.header.flags & PACKET_FLAG_CRC32C) {
+            uint32_t crc = packet.checksum();
+            uint8_t trailer[PACKET_CHECKSUM_SIZE];
+            // Little-endian on the wire regardless of the host.
+            for (size_t i = 0; i < PACKET_CHECKSUM_SIZE; ++i) {
+                trailer[i] = static_cast<uint8_t>(crc >> (8 * i));
+            }
+            udp.write(trailer, sizeof(trailer));
+        }
+        if (!udp.endPacket()) {
+            return false;
+        }
+        if (frameTap) {
+            // A debugging aid, so the copy for the tap is the one allocation left on this path.
+            std::vector<uint8_t> frame(packet.serializedSize());
+            packet.serialize(frame.data(), frame.size());
+            tapFrame(FrameDirection::Sent, frame.data(), frame.size());
+        }
+        return true;
+    }
+
+    bool ESP8266Transport::send(const Packet& packet) {
+        return send(packet.view());
+    }
+
+    bool ESP8266Transport::send(const PacketView& packet) {
+        if (!initialized) return false;
 
         if (clients.empty()) {
             // Optional: Log if there are no clients to send to.
@@ -118,52 +231,48 @@ namespace YunaProtocol {
             return true; // Return true as there was no error.
         }
         // Send the packet to all clients in the map, sourceID is the node id not the destination id.
-        for (const auto& client_pair : clients) {
-            // client_pair.first is the client's node ID (uint32_t)
-            // client_pair.second is the client's IP address (IPAddress)
-            const IPAddress& clientAddr = client_pair.second;
-
-            udp.beginPacket(clientAddr, broadcastPort);
-            udp.write(buffer.data(), buffer.size());
-            if (!udp.endPacket()) {
-                Serial.printf("Failed to send packet to client %u at %s\n", client_pair.first, clientAddr.toString().c_str());
+        for (const auto& client : clients) {
+            if (!writeDatagram(client.address, packet)) {
+                Serial.printf("Failed to send packet to client %u at %s\n", client.id, client.address.toString().c_str());
             }
         }
+        return true;
+    }
 
+    bool ESP8266Transport::sendTo(uint32_t clientId, const Packet& packet) {
+        return sendTo(clientId, packet.view());
+    }
 
+    bool ESP8266Transport::sendTo(uint32_t clientId, const PacketView& packet) {
+        if (!initialized) return false;
 
+        const IPAddress *address = clients.find(clientId);
+        if (!address) {
+            return false;
+        }
 
-
-
-
-
+        if (!writeDatagram(*address, packet)) {
+            Serial.printf("Failed to send packet to client %u at %s\n", clientId, address->toString().c_str());
+            return false;
+        }
         return true;
     }
 
     bool ESP8266Transport::broadcast(const Packet& packet) {
-        if (!initialized) return false;
+        return broadcast(packet.view());
+    }
 
-        // Serialize the packet into a buffer.
-        std::vector<uint8_t> buffer;
-        if (!packet.serialize(buffer)) {
-            Serial.println("Error: Failed to serialize packet for broadcast.");
-            return false;
-        }
+    bool ESP8266Transport::broadcast(const PacketView& packet) {
+        if (!initialized) return false;
 
         // The broadcast IP for a typical home network is 255.255.255.255.
         IPAddress broadcastIp(255, 255, 255, 255);
 
         // Send the packet.
-        if (!udp.beginPacket(broadcastIp, broadcastPort)) {
-            Serial.println("Error: udp.beginPacket() failed.");
+        if (!writeDatagram(broadcastIp, packet)) {
+            Serial.println("Error: Failed to send broadcast packet.");
             return false;
         }
-        udp.write(buffer.data(), buffer.size());
-        if (!udp.endPacket()) {
-            Serial.println("Error: udp.endPacket() failed to send.");
-            return false;
-        }
-
         return true;
     }
 
@@ -171,8 +280,8 @@ namespace YunaProtocol {
         std::vector<uint32_t> clientIds;
         clientIds.reserve(clients.size());
 
-        for (const auto& pair : clients) {
-            clientIds.push_back(pair.first);
+        for (const auto& client : clients) {
+            clientIds.push_back(client.id);
         }
         return clientIds;
     }
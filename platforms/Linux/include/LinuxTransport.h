@@ -0,0 +1,233 @@
+//
+// LinuxTransport.h
+//
+
+#ifndef LINUX_TRANSPORT_H
+#define LINUX_TRANSPORT_H
+
+// --- System Includes ---
+#define LINUX_DISCOVERY_INTERVAL 5000
+#include <netinet/in.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// --- Project Includes ---
+#include "Discovery.h"
+#include "Transport.h" // Base class interface
+
+// Most segments the kernel accepts in one UDP_SEGMENT send (UDP_MAX_SEGMENTS).
+#define LINUX_GSO_MAX_SEGMENTS 64
+// Largest UDP payload, the limit for a coalesced send or receive.
+#define LINUX_MAX_UDP_PAYLOAD 65507
+
+namespace YunaProtocol {
+
+    /**
+     * @class LinuxTransport
+     * @brief An implementation of the YunaTransport interface for Linux using a UDP socket.
+     *
+     * This class mirrors WindowsTransport on top of POSIX sockets: it supports unicast,
+     * broadcast and automatic discovery of clients, and marks outgoing packets with the
+     * DSCP and socket priority of their priority class. Sending is safe from any thread while
+     * loop() runs on another one.
+     */
+    class LinuxTransport : public YunaTransport {
+    public:
+        /**
+         * @brief Constructs a LinuxTransport instance.
+         * @param port The UDP port to listen on for incoming packets. Defaults to 42069.
+         */
+        explicit LinuxTransport(int port = 42069);
+
+        /**
+         * @brief Destructor. Closes the socket.
+         */
+        ~LinuxTransport() override;
+
+        // --- Overridden Interface Methods ---
+
+        /**
+         * @brief Initializes the transport layer.
+         *
+         * Creates a UDP socket, binds it to the listening port on every interface,
+         * enables broadcasting and switches it to non-blocking mode. The next loop() calls then
+         * send a short burst of joins that running peers answer with the peers they know.
+         */
+        bool initialize() override;
+
+        /**
+         * @brief Sends a packet to every known client.
+         * @param packet The packet to send.
+         * @return True unless serialization failed.
+         */
+        bool send(const Packet& packet) override;
+
+        /**
+         * @brief Sends a packet view to every known client, without the virtual call.
+         */
+        bool send(const PacketView& packet);
+
+        /**
+         * @brief Sends a packet to a single known client.
+         * @param clientId The destination client ID.
+         * @param packet The packet to send.
+         * @return True if the packet was sent, false if the client is unknown or an error occurred.
+         */
+        bool sendTo(uint32_t clientId, const Packet& packet) override;
+
+        bool sendTo(uint32_t clientId, const PacketView& packet);
+
+        /**
+         * @brief Broadcasts discovery packets periodically, then receives and dispatches one incoming packet.
+         *
+         * Since the socket is non-blocking, this call returns immediately if no data is available.
+         */
+        void loop() override;
+
+        /**
+         * @brief Does the work of loop(), handing received packets to a sink instead of the data callback.
+         *
+         * The sink is called with a view into the receive buffer, valid for the duration of the call.
+         * Being a template, the whole receive path can be inlined into the caller (see StaticNode).
+         * @param sink Any callable taking a const PacketView&.
+         */
+        template <typename Sink>
+        void poll(Sink& sink) {
+            if (!initialized) return;
+            broadcastDiscoveryIfDue();
+
+            sockaddr_in senderAddr{};
+            PacketTimestamps stamps;
+            size_t segmentSize = 0;
+            size_t bytesReceived = receiveDatagram(senderAddr, stamps, segmentSize);
+            // A GRO datagram holds equally sized segments, only the last one may be shorter.
+            for (size_t offset = 0; offset < bytesReceived; offset += segmentSize) {
+                PacketView packet;
+                size_t length = std::min(segmentSize, bytesReceived - offset);
+                if (acceptDatagram(receiveBuffer.data() + offset, length, senderAddr, stamps, packet)) {
+                    sink(packet);
+                }
+            }
+        }
+
+        /**
+         * @brief Broadcasts a packet to all devices on the local network.
+         * @param packet The packet to broadcast.
+         * @return True if the broadcast was sent successfully, false otherwise.
+         */
+        bool broadcast(const Packet& packet) override;
+
+        bool broadcast(const PacketView& packet);
+
+        /**
+         * @brief Lists the unique IDs of all clients from which a packet has been received.
+         * @return A vector of client source IDs.
+         */
+        std::vector<uint32_t> listConnectedClients() override;
+
+        /**
+         * @brief Sends several packets to every known client.
+         *
+         * With segmentation offload enabled, each run of equally sized packets goes to a client in
+         * a single UDP_SEGMENT sendmsg() and the kernel or NIC cuts it into datagrams. Otherwise,
+         * or if the kernel rejects it, every packet is sent on its own.
+         * @param packets The packets to send.
+         * @param count The number of packets.
+         * @return True unless serialization failed.
+         */
+        bool sendBatch(const Packet* packets, size_t count) override;
+
+        /**
+         * @brief Sets IP_TOS and SO_PRIORITY for the packets sent from now on.
+         *
+         * The options are only changed when the class differs from the previous packet's.
+         * SO_PRIORITY values above 6 would need CAP_NET_ADMIN, so none are used.
+         */
+        void setTrafficClass(PriorityClass priority) override;
+
+        /**
+         * @brief Attaches the kernel receive timestamp (SO_TIMESTAMPING) to every received packet.
+         *
+         * Software timestamps land in Packet::timestamps.kernelRxNs. With hardware timestamping,
+         * the NIC on interfaceName is switched to timestamp all received packets and the raw NIC
+         * time lands in Packet::timestamps.hardwareRxNs; if the NIC or driver refuses, only
+         * software timestamps are used. Can be called before or after initialize().
+         * @param hardware Also request hardware timestamps.
+         * @param interfaceName The interface to enable hardware timestamping on, e.g. "eth0".
+         * @return False if the kernel rejected SO_TIMESTAMPING on an initialized socket.
+         */
+        bool enableKernelTimestamps(bool hardware = false, const std::string& interfaceName = "");
+
+        /**
+         * @brief Enables UDP generic segmentation (GSO) on send and receive offload (GRO) on receive.
+         *
+         * GSO is used by sendBatch(); GRO lets the kernel coalesce datagrams from the same peer,
+         * which loop() splits back into packets. Each half falls back to plain datagrams on its own
+         * when the kernel does not support it (GSO needs Linux 4.18, GRO 5.0); GSO support is probed
+         * once, and a single rejected segmented send only falls back for that batch. Can be called
+         * before or after initialize().
+         * @param enabled True to use the offloads.
+         */
+        void enableSegmentationOffload(bool enabled);
+
+        void set_broadcast_port(int port);
+
+    private:
+        bool applyTimestamping();
+
+        void applyOffload();
+
+        void broadcastDiscoveryIfDue();
+
+        void answerJoin(uint32_t joinerId);
+
+        void addListedPeers(const PacketView& reply);
+
+        size_t receiveDatagram(sockaddr_in& senderAddr, PacketTimestamps& stamps, size_t& segmentSize);
+
+        bool acceptDatagram(const uint8_t* data, size_t size, const sockaddr_in& senderAddr,
+                            const PacketTimestamps& stamps, PacketView& packet);
+
+        bool sendSegments(const uint8_t* data, size_t size, uint16_t segmentSize, const sockaddr_in& address);
+
+        bool sendBuffer(const uint8_t* data, size_t size, const sockaddr_in& address);
+
+        // A run of equally sized datagrams in batchBuffer, where only the last one may be shorter.
+        struct BatchRun {
+            size_t offset;
+            size_t size;
+            uint16_t segmentSize;
+        };
+
+        // --- Member Variables ---
+
+        int socketFd;                                         // The UDP socket used for all network operations.
+        sockaddr_in serverAddr;                               // The local address this transport is bound to.
+        int listeningPort;                                    // The port number for listening.
+        int broadcastPort;                                    // The port number for broadcasting.
+        std::map<uint32_t, sockaddr_in> clients;              // Known clients [ClientID -> Address].
+        std::mutex clientsMutex;                              // Guards clients and the send buffers below.
+        bool initialized;                                     // Set once initialize() succeeded.
+        std::atomic<int> currentTrafficClass;                 // PriorityClass applied to the socket, -1 if none yet.
+        bool kernelTimestamps = false;                        // SO_TIMESTAMPING requested.
+        bool hardwareTimestamps = false;                      // Hardware receive timestamps requested.
+        std::string timestampInterface;                       // Interface to enable hardware timestamps on.
+        bool segmentationOffload = false;                     // GSO and GRO requested.
+        bool sendOffload = false;                             // GSO requested and supported by the kernel.
+        bool receiveOffload = false;                          // GRO accepted by the kernel.
+        std::vector<uint8_t> receiveBuffer;                   // Sized for a coalesced datagram when GRO is on.
+        std::vector<uint8_t> batchBuffer;                     // Serialized packets of the current sendBatch().
+        std::vector<BatchRun> batchRuns;                      // Segmentable runs within batchBuffer.
+        std::vector<uint8_t> sendScratch;                     // Reused to serialize single packets.
+        std::chrono::steady_clock::time_point lastDiscoveryBroadcast{};
+        JoinSchedule joinSchedule;                            // Discovery burst sent after initialize().
+    };
+
+} // namespace YunaProtocol
+
+#endif //LINUX_TRANSPORT_H
@@ -0,0 +1,269 @@
+//
+// XdpTransport.h
+//
+
+#ifndef XDP_TRANSPORT_H
+#define XDP_TRANSPORT_H
+
+// --- System Includes ---
+#define XDP_DISCOVERY_INTERVAL 5000
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// --- Project Includes ---
+#include "Discovery.h"
+#include "Transport.h" // Base class interface
+
+namespace YunaProtocol {
+
+    using PacketViewCallback = std::function<void(const PacketView& packet)>;
+
+    /**
+     * @brief How the XDP program is attached to the interface.
+     */
+    enum class XdpAttachMode {
+        Auto, // Native driver mode with zero-copy if available, else generic (SKB) mode.
+        Native, // Driver mode only, copy or zero-copy.
+        Generic, // SKB mode: works on any interface, e.g. veth pairs, without the speed-up.
+    };
+
+    /**
+     * @class XdpTransport
+     * @brief A kernel-bypass UDP transport built on an AF_XDP socket, for gateways receiving from many devices.
+     *
+     * A small XDP program redirects IPv4 UDP datagrams for the listening port on one receive queue
+     * into a UMEM frame pool shared with this process; everything else, e.g. ARP, still goes to
+     * the kernel. loop() parses the Ethernet, IP and UDP headers and the PacketHeader straight from
+     * the frames. Peers are learned from received frames, so unicast replies need no ARP lookup.
+     *
+     * Sending is safe from any thread while loop() runs; the transmit ring is filled under a lock.
+     *
+     * Needs CAP_NET_ADMIN and CAP_BPF (or root) and Linux 5.9 or later. Only the given queue is
+     * served, so on multi-queue NICs steer the port to it (ethtool -N) or use one transport per queue.
+     */
+    class XdpTransport : public YunaTransport {
+    public:
+        /**
+         * @brief Constructs an XdpTransport instance.
+         * @param interfaceName The interface to attach to, e.g. "eth0".
+         * @param port The UDP port to receive on. Defaults to 42069.
+         * @param queueId The receive queue of the interface to serve.
+         * @param mode How to attach the XDP program.
+         */
+        explicit XdpTransport(std::string interfaceName, int port = 42069, uint32_t queueId = 0,
+                              XdpAttachMode mode = XdpAttachMode::Auto);
+
+        /**
+         * @brief Destructor. Detaches the XDP program and releases the socket and UMEM.
+         */
+        ~XdpTransport() override;
+
+        XdpTransport(const XdpTransport&) = delete;
+        XdpTransport& operator=(const XdpTransport&) = delete;
+
+        // --- Overridden Interface Methods ---
+
+        /**
+         * @brief Creates the UMEM and rings, loads and attaches the XDP program and binds the socket.
+         *
+         * In Auto mode, native attachment and zero-copy binding are tried first, then each falls
+         * back to the slower mode. The next loop() calls send a short burst of joins; peers listed
+         * in the replies are not added, as their MAC is unknown, but announce themselves on their own.
+         */
+        bool initialize() override;
+
+        /**
+         * @brief Sends a packet to every known client.
+         * @param packet The packet to send.
+         * @return False if no transmit frame was free.
+         */
+        bool send(const Packet& packet) override;
+
+        /**
+         * @brief Sends a packet view to every known client, without the virtual call.
+         */
+        bool send(const PacketView& packet);
+
+        /**
+         * @brief Sends a packet to a single known client.
+         * @param clientId The destination client ID.
+         * @param packet The packet to send.
+         * @return True if the packet was queued, false if the client is unknown or no frame was free.
+         */
+        bool sendTo(uint32_t clientId, const Packet& packet) override;
+
+        bool sendTo(uint32_t clientId, const PacketView& packet);
+
+        /**
+         * @brief Broadcasts discovery packets periodically, then handles up to one batch of received frames.
+         */
+        void loop() override;
+
+        /**
+         * @brief Does the work of loop(), handing received packets to a sink instead of the callbacks.
+         *
+         * The sink is called with views into the UMEM frames, valid for the duration of the call.
+         * @param sink Any callable taking a const PacketView&.
+         */
+        template <typename Sink>
+        void poll(Sink& sink) {
+            if (!initialized) return;
+            broadcastDiscoveryIfDue();
+
+            uint32_t frames = beginReceive();
+            for (uint32_t i = 0; i < frames; ++i) {
+                PacketView packet;
+                if (acceptFrame(i, packet)) {
+                    sink(packet);
+                }
+            }
+            endReceive(frames);
+        }
+
+        /**
+         * @brief Broadcasts a packet to all devices on the local network.
+         * @param packet The packet to broadcast.
+         * @return True if the broadcast was queued.
+         */
+        bool broadcast(const Packet& packet) override;
+
+        bool broadcast(const PacketView& packet);
+
+        /**
+         * @brief Lists the unique IDs of all clients from which a packet has been received.
+         * @return A vector of client source IDs.
+         */
+        std::vector<uint32_t> listConnectedClients() override;
+
+        /**
+         * @brief Writes the DSCP of a class into the IPv4 header of the frames built from now on.
+         */
+        void setTrafficClass(PriorityClass priority) override;
+
+        /**
+         * @brief Receives packets as views into the UMEM frames instead of copies.
+         *
+         * When set, it replaces the data callback: nothing is copied between the NIC and it. The
+         * view is only valid during the call, as its frame is handed back to the kernel afterwards.
+         * @param callback The function to call with every received packet.
+         */
+        void registerPacketViewCallback(const PacketViewCallback& callback);
+
+        /**
+         * @brief Sets how many received frames one loop() handles at most.
+         */
+        void set_batch_size(uint32_t frames);
+
+        void set_broadcast_port(int port);
+
+        /**
+         * @brief Whether the XDP program runs in the driver (true) or in generic SKB mode.
+         */
+        bool isNativeMode() const;
+
+        /**
+         * @brief Whether the NIC writes frames straight into the UMEM.
+         */
+        bool isZeroCopy() const;
+
+        /**
+         * @brief Number of received frames dropped because they could not be parsed or decoded.
+         */
+        uint64_t getDroppedFrameCount() const;
+
+    private:
+        // Single-producer single-consumer ring shared with the kernel.
+        struct Ring {
+            uint32_t *producer = nullptr;
+            uint32_t *consumer = nullptr;
+            uint32_t *flags = nullptr;
+            void *descriptors = nullptr;
+            uint32_t mask = 0;
+            void *mapping = nullptr;
+            size_t mappingSize = 0;
+        };
+
+        // Addressing learned from a client's frames.
+        struct Endpoint {
+            uint8_t mac[6];
+            uint32_t ip; // Network byte order.
+            uint16_t port; // Network byte order.
+        };
+
+        bool createSocket();
+
+        bool mapRing(Ring& ring, uint64_t offset, const void* ringOffsets, size_t descriptorSize);
+
+        bool loadProgram();
+
+        bool attachProgram(uint32_t flags);
+
+        bool bindSocket(uint16_t flags);
+
+        bool readInterfaceAddresses();
+
+        void broadcastDiscoveryIfDue();
+
+        void answerJoin(uint32_t joinerId);
+
+        uint32_t beginReceive();
+
+        bool acceptFrame(uint32_t index, PacketView& packet);
+
+        void endReceive(uint32_t frames);
+
+        void reclaimCompletions();
+
+        bool transmitFrame(const PacketView& packet, const Endpoint& destination);
+
+        void release();
+
+        // --- Member Variables ---
+
+        std::string interfaceName;
+        int listeningPort;
+        int broadcastPort;
+        uint32_t queueId;
+        XdpAttachMode mode;
+        unsigned int interfaceIndex = 0;
+        uint8_t localMac[6] = {};
+        uint32_t localIp = 0; // Network byte order.
+        std::atomic<uint8_t> typeOfService{0}; // TOS byte of the frames built next, the DSCP in its upper six bits.
+
+        int xskFd = -1; // The AF_XDP socket.
+        int mapFd = -1; // XSKMAP the program redirects into.
+        int programFd = -1;
+        int linkFd = -1; // Keeps the program attached until closed.
+        bool nativeMode = false;
+        bool zeroCopy = false;
+        bool initialized = false;
+
+        uint8_t* umem = nullptr;
+        size_t umemSize = 0;
+        uint32_t frameSize = 2048;
+        uint32_t frameCount = 4096; // First half feeds the fill ring, second half is for transmit.
+        uint32_t ringSize = 2048;
+        uint32_t batchSize = 64;
+        Ring fillRing;
+        Ring completionRing;
+        Ring rxRing;
+        Ring txRing;
+        std::vector<uint64_t> freeTxFrames;
+
+        std::map<uint32_t, Endpoint> clients;             // Known clients [ClientID -> Address].
+        std::mutex txMutex;                               // Guards clients and the transmit side: txRing, completionRing, freeTxFrames.
+        PacketViewCallback viewCallback;
+        uint64_t droppedFrames = 0;
+        std::chrono::steady_clock::time_point lastDiscoveryBroadcast{};
+        JoinSchedule joinSchedule; // Discovery burst sent after initialize().
+    };
+
+} // namespace YunaProtocol
+
+#endif //XDP_TRANSPORT_H
@@ -0,0 +1,529 @@
+//
+// LinuxTransport.cpp
+//
+
+#include "LinuxTransport.h"
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream> // For error logging
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#include <linux/sockios.h>
+#include <net/if.h>
+#include <netinet/ip.h>
+#include <netinet/udp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+
+namespace YunaProtocol {
+
+    namespace {
+        uint32_t steadyMs() {
+            return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+    }
+
+    // --- Constructor & Destructor ---
+
+    LinuxTransport::LinuxTransport(int port)
+        : socketFd(-1), serverAddr{}, listeningPort(port), broadcastPort(port), initialized(false),
+          currentTrafficClass(-1) {
+    }
+
+    LinuxTransport::~LinuxTransport() {
+        if (socketFd >= 0) {
+            close(socketFd);
+        }
+    }
+
+    // --- Interface Implementation ---
+
+    bool LinuxTransport::initialize() {
+        // 1. Create a UDP socket
+        socketFd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (socketFd < 0) {
+            std::cerr << "socket failed with error: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        // 2. Bind the socket to a local address and port
+        serverAddr.sin_family = AF_INET;
+        serverAddr.sin_port = htons(this->listeningPort);
+        serverAddr.sin_addr.s_addr = INADDR_ANY; // Listen on any available network interface
+
+        if (bind(socketFd, reinterpret_cast<sockaddr*>(&serverAddr), sizeof(serverAddr)) < 0) {
+            std::cerr << "bind failed with error: " << std::strerror(errno) << std::endl;
+            close(socketFd);
+            socketFd = -1;
+            return false;
+        }
+
+        // 3. Enable broadcasting
+        int broadcastOption = 1;
+        if (setsockopt(socketFd, SOL_SOCKET, SO_BROADCAST, &broadcastOption, sizeof(broadcastOption)) < 0) {
+            std::cerr << "setsockopt SO_BROADCAST failed with error: " << std::strerror(errno) << std::endl;
+            close(socketFd);
+            socketFd = -1;
+            return false;
+        }
+
+        // 4. Set the socket to non-blocking mode
+        int flags = fcntl(socketFd, F_GETFL, 0);
+        if (flags < 0 || fcntl(socketFd, F_SETFL, flags | O_NONBLOCK) < 0) {
+            std::cerr << "fcntl O_NONBLOCK failed with error: " << std::strerror(errno) << std::endl;
+            close(socketFd);
+            socketFd = -1;
+            return false;
+        }
+
+        applyOffload();
+
+        if (kernelTimestamps && !applyTimestamping()) {
+            std::cerr << "Kernel receive timestamps unavailable, continuing without them." << std::endl;
+            kernelTimestamps = false;
+        }
+
+        joinSchedule.start(steadyMs(), clientID ^ static_cast<uint32_t>(getpid()) << 16 ^ steadyMs());
+        initialized = true;
+        std::cout << "LinuxTransport initialized successfully on port " << this->listeningPort << "." << std::endl;
+        return true;
+    }
+
+    void LinuxTransport::loop() {
+        auto forward = [this](const PacketView& packet) {
+            if (callback) {
+                callback(packet.toPacket());
+            }
+        };
+        poll(forward);
+    }
+
+    void LinuxTransport::broadcastDiscoveryIfDue() {
+        // Broadcast Discovery Peer Packet
+        auto now = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastDiscoveryBroadcast);
+
+        bool joining = joinSchedule.due(steadyMs());
+        if (joining || elapsed.count() > LINUX_DISCOVERY_INTERVAL) {
+            lastDiscoveryBroadcast = now;
+            PacketView discoveryPacket;
+            discoveryPacket.header.protocolVersion = PROTOCOL_VERSION;
+            discoveryPacket.header.packetType = DISCOVERY_PEER;
+            discoveryPacket.header.sourceId = clientID;
+            discoveryPacket.header.payloadLength = 0; // No payload for discovery
+            if (joining) {
+                discoveryPacket.header.flags |= PACKET_FLAG_JOIN;
+            }
+
+            setTrafficClass(PriorityClass::Control); // Not the class of whatever data went out last.
+            if (!broadcast(discoveryPacket)) {
+                std::cerr << "Failed to broadcast discovery packet." << std::endl;
+            }
+        }
+    }
+
+    size_t LinuxTransport::receiveDatagram(sockaddr_in& senderAddr, PacketTimestamps& stamps, size_t& segmentSize) {
+        // Prepare to receive data from the socket.
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(scm_timestamping)) + CMSG_SPACE(sizeof(int))];
+
+        iovec vector{receiveBuffer.data(), receiveBuffer.size()};
+        msghdr message{};
+        message.msg_name = &senderAddr;
+        message.msg_namelen = sizeof(senderAddr);
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        ssize_t bytesReceived = recvmsg(socketFd, &message, 0);
+        if (bytesReceived <= 0) {
+            if (bytesReceived < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cerr << "recvmsg failed with error: " << std::strerror(errno) << std::endl;
+            }
+            return 0;
+        }
+
+        segmentSize = static_cast<size_t>(bytesReceived);
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING) {
+                scm_timestamping kernelStamps{};
+                std::memcpy(&kernelStamps, CMSG_DATA(cmsg), sizeof(kernelStamps));
+                // ts[0] is the software timestamp, ts[2] the raw hardware one.
+                stamps.kernelRxNs =
+                    static_cast<uint64_t>(kernelStamps.ts[0].tv_sec) * 1000000000ull + kernelStamps.ts[0].tv_nsec;
+                stamps.hardwareRxNs =
+                    static_cast<uint64_t>(kernelStamps.ts[2].tv_sec) * 1000000000ull + kernelStamps.ts[2].tv_nsec;
+            } else if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+                int coalescedSize = 0;
+                std::memcpy(&coalescedSize, CMSG_DATA(cmsg), sizeof(coalescedSize));
+                if (coalescedSize > 0) {
+                    segmentSize = static_cast<size_t>(coalescedSize);
+                }
+            }
+        }
+        return static_cast<size_t>(bytesReceived);
+    }
+
+    bool LinuxTransport::acceptDatagram(const uint8_t* data, size_t size, const sockaddr_in& senderAddr,
+                                        const PacketTimestamps& stamps, PacketView& packet) {
+        tapFrame(FrameDirection::Received, data, size);
+        DecodeStatus status = packet.decode(data, size);
+        if (status == DecodeStatus::Ok) {
+            if (kernelTimestamps) {
+                packet.timestamps = stamps;
+                packet.timestamps.decodedNs = wallClockNs();
+            }
+            uint32_t sourceId = packet.header.sourceId;
+            if (sourceId == clientID) { return false; }
+            bool joining = packet.header.packetType == DISCOVERY_PEER && (packet.header.flags & PACKET_FLAG_JOIN);
+            bool discovered;
+            {
+                std::lock_guard<std::mutex> lock(clientsMutex);
+                // A known peer that joins again has restarted, possibly at another address.
+                discovered = joining ? clients.insert_or_assign(sourceId, senderAddr).second
+                                     : clients.try_emplace(sourceId, senderAddr).second;
+            }
+            if (discovered) {
+                char ipStr[INET_ADDRSTRLEN];
+                inet_ntop(AF_INET, &(senderAddr.sin_addr), ipStr, INET_ADDRSTRLEN);
+                std::cout << "New client discovered with ID, addr: " << sourceId << " "
+                          << std::string(ipStr) + ":" + std::to_string(ntohs(senderAddr.sin_port)) << std::endl;
+            }
+            if (discovered || joining) {
+                notifyPeerDiscovered(sourceId); // Outside the lock: the listener sends.
+            }
+            if (joining) {
+                answerJoin(sourceId);
+            } else if (packet.header.packetType == DISCOVERY_REPLY) {
+                addListedPeers(packet);
+                return false;
+            }
+            return packet.header.packetType != DISCOVERY_PEER;
+        }
+        if (status == DecodeStatus::ChecksumMismatch) {
+            corruptedPackets++;
+            std::cerr << "Dropped corrupted packet of size " << size << std::endl;
+        } else {
+            std::cerr << "Failed to deserialize packet of size " << size << std::endl;
+        }
+        return false;
+    }
+
+    void LinuxTransport::answerJoin(uint32_t joinerId) {
+        uint8_t entries[MAX_PEERS_PER_REPLY * PEER_ENTRY_SIZE];
+        size_t size = 0;
+        {
+            std::lock_guard<std::mutex> lock(clientsMutex);
+            for (const auto& [clientId, clientAddr] : clients) {
+                if (clientId == joinerId) continue;
+                if (size == sizeof(entries)) break;
+                PeerAddress peer;
+                peer.clientId = clientId;
+                peer.ipv4 = ntohl(clientAddr.sin_addr.s_addr);
+                peer.port = ntohs(clientAddr.sin_port);
+                writePeerEntry(peer, entries + size);
+                size += PEER_ENTRY_SIZE;
+            }
+        }
+
+        PacketView reply;
+        reply.header.packetType = DISCOVERY_REPLY;
+        reply.header.sourceId = clientID;
+        reply.header.payloadLength = static_cast<uint16_t>(size);
+        reply.payload = entries;
+        setTrafficClass(PriorityClass::Control);
+        sendTo(joinerId, reply);
+    }
+
+    void LinuxTransport::addListedPeers(const PacketView& reply) {
+        joinSchedule.onReply();
+        for (size_t offset = 0; offset + PEER_ENTRY_SIZE <= reply.header.payloadLength; offset += PEER_ENTRY_SIZE) {
+            PeerAddress peer = readPeerEntry(reply.payload + offset);
+            if (peer.clientId == clientID) continue;
+            sockaddr_in peerAddr{};
+            peerAddr.sin_family = AF_INET;
+            peerAddr.sin_addr.s_addr = htonl(peer.ipv4);
+            peerAddr.sin_port = htons(peer.port);
+            {
+                std::lock_guard<std::mutex> lock(clientsMutex);
+                if (!clients.try_emplace(peer.clientId, peerAddr).second) continue;
+            }
+            char ipStr[INET_ADDRSTRLEN];
+            inet_ntop(AF_INET, &(peerAddr.sin_addr), ipStr, INET_ADDRSTRLEN);
+            std::cout << "New client listed by " << reply.header.sourceId << " with ID, addr: " << peer.clientId << " "
+                      << std::string(ipStr) + ":" + std::to_string(ntohs(peerAddr.sin_port)) << std::endl;
+            notifyPeerDiscovered(peer.clientId);
+        }
+    }
+
+    bool LinuxTransport::sendBuffer(const uint8_t* data, size_t size, const sockaddr_in& address) {
+        ssize_t bytesSent = sendto(socketFd, data, size, 0,
+                                   reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+        if (bytesSent < 0) {
+            return false;
+        }
+        tapFrame(FrameDirection::Sent, data, size);
+        return static_cast<size_t>(bytesSent) == size;
+    }
+
+    bool LinuxTransport::send(const Packet& packet) {
+        return send(packet.view());
+    }
+
+    bool LinuxTransport::send(const PacketView& packet) {
+        if (!initialized) return false;
+        std::lock_guard<std::mutex> lock(clientsMutex);
+
+        sendScratch.resize(packet.serializedSize());
+        packet.serialize(sendScratch.data(), sendScratch.size());
+
+        // Send the packet to all clients in the map, sourceID is the node id not the destination id.
+        for (const auto& [clientId, clientAddr] : clients) {
+            if (!sendBuffer(sendScratch.data(), sendScratch.size(), clientAddr)) {
+                std::cerr << "sendto failed for client " << clientId << " with error: " << std::strerror(errno) << std::endl;
+            }
+        }
+        return true;
+    }
+
+    bool LinuxTransport::sendTo(uint32_t clientId, const Packet& packet) {
+        return sendTo(clientId, packet.view());
+    }
+
+    bool LinuxTransport::sendTo(uint32_t clientId, const PacketView& packet) {
+        if (!initialized) return false;
+        std::lock_guard<std::mutex> lock(clientsMutex);
+
+        auto client = clients.find(clientId);
+        if (client == clients.end()) {
+            return false;
+        }
+
+        sendScratch.resize(packet.serializedSize());
+        packet.serialize(sendScratch.data(), sendScratch.size());
+        if (!sendBuffer(sendScratch.data(), sendScratch.size(), client->second)) {
+            std::cerr << "sendto failed for client " << clientId << " with error: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool LinuxTransport::broadcast(const Packet& packet) {
+        return broadcast(packet.view());
+    }
+
+    bool LinuxTransport::broadcast(const PacketView& packet) {
+        if (!initialized) return false;
+        std::lock_guard<std::mutex> lock(clientsMutex);
+
+        sendScratch.resize(packet.serializedSize());
+        packet.serialize(sendScratch.data(), sendScratch.size());
+
+        sockaddr_in broadcastAddr{};
+        broadcastAddr.sin_family = AF_INET;
+        broadcastAddr.sin_port = htons(this->broadcastPort);
+        broadcastAddr.sin_addr.s_addr = INADDR_BROADCAST;
+
+        if (!sendBuffer(sendScratch.data(), sendScratch.size(), broadcastAddr)) {
+            std::cerr << "broadcast sendto failed with error: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool LinuxTransport::sendBatch(const Packet* packets, size_t count) {
+        if (!initialized) return false;
+        if (!sendOffload || count < 2) {
+            return YunaTransport::sendBatch(packets, count);
+        }
+        std::lock_guard<std::mutex> lock(clientsMutex);
+
+        // Serialize everything once, then cut it into runs the kernel can segment:
+        // equally sized datagrams, where only the last one may be shorter.
+        batchRuns.clear();
+        batchBuffer.clear();
+        size_t segments = 0;
+        for (size_t i = 0; i < count; ++i) {
+            PacketView view = packets[i].view();
+            size_t size = view.serializedSize();
+            size_t offset = batchBuffer.size();
+            batchBuffer.resize(offset + size);
+            if (view.serialize(batchBuffer.data() + offset, size) != size) {
+                std::cerr << "Failed to serialize packet for sending." << std::endl;
+                return false;
+            }
+            bool extendsRun = !batchRuns.empty() && segments < LINUX_GSO_MAX_SEGMENTS &&
+                              size <= batchRuns.back().segmentSize &&
+                              batchRuns.back().size % batchRuns.back().segmentSize == 0 &&
+                              batchRuns.back().size + size <= LINUX_MAX_UDP_PAYLOAD;
+            if (extendsRun) {
+                batchRuns.back().size += size;
+                segments++;
+            } else {
+                batchRuns.push_back({offset, size, static_cast<uint16_t>(size)});
+                segments = 1;
+            }
+        }
+
+        for (const auto& [clientId, clientAddr] : clients) {
+            for (const BatchRun& run : batchRuns) {
+                if (!sendSegments(batchBuffer.data() + run.offset, run.size, run.segmentSize, clientAddr)) {
+                    std::cerr << "sendmsg failed for client " << clientId << " with error: " << std::strerror(errno) << std::endl;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool LinuxTransport::sendSegments(const uint8_t* data, size_t size, uint16_t segmentSize, const sockaddr_in& address) {
+        if (sendOffload && size > segmentSize) {
+            alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint16_t))] = {};
+            iovec vector{const_cast<uint8_t*>(data), size};
+            msghdr message{};
+            message.msg_name = const_cast<sockaddr_in*>(&address);
+            message.msg_namelen = sizeof(address);
+            message.msg_iov = &vector;
+            message.msg_iovlen = 1;
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+            cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            std::memcpy(CMSG_DATA(cmsg), &segmentSize, sizeof(segmentSize));
+
+            ssize_t bytesSent = sendmsg(socketFd, &message, 0);
+            if (bytesSent >= 0) {
+                for (size_t offset = 0; offset < size; offset += segmentSize) {
+                    tapFrame(FrameDirection::Sent, data + offset, std::min<size_t>(segmentSize, size - offset));
+                }
+                return static_cast<size_t>(bytesSent) == size;
+            }
+            if (errno != EINVAL && errno != EOPNOTSUPP && errno != EIO) {
+                return false;
+            }
+            // Support was probed in applyOffload(), so this is about this send only, e.g. a route
+            // through a device without checksum offload: send these packets one datagram at a time.
+        }
+
+        bool sent = true;
+        for (size_t offset = 0; offset < size; offset += segmentSize) {
+            size_t length = std::min<size_t>(segmentSize, size - offset);
+            ssize_t bytesSent = sendto(socketFd, data + offset, length, 0,
+                                       reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+            if (bytesSent < 0) {
+                sent = false;
+                continue;
+            }
+            tapFrame(FrameDirection::Sent, data + offset, length);
+        }
+        return sent;
+    }
+
+    std::vector<uint32_t> LinuxTransport::listConnectedClients() {
+        std::lock_guard<std::mutex> lock(clientsMutex);
+        std::vector<uint32_t> clientIds;
+        clientIds.reserve(clients.size());
+        for (const auto& [clientId, clientAddr] : clients) {
+            clientIds.push_back(clientId);
+        }
+        return clientIds;
+    }
+
+    void LinuxTransport::setTrafficClass(PriorityClass priority) {
+        // Exchanged, as loop() marks discovery traffic while other threads send data.
+        if (!initialized || currentTrafficClass.exchange(static_cast<int>(priority)) == static_cast<int>(priority)) return;
+
+        // The DSCP occupies the upper six bits of the TOS byte.
+        int tos = dscpForPriority(priority) << 2;
+        if (setsockopt(socketFd, IPPROTO_IP, IP_TOS, &tos, sizeof(tos)) < 0) {
+            std::cerr << "setsockopt IP_TOS failed with error: " << std::strerror(errno) << std::endl;
+        }
+        int socketPriority = socketPriorityFor(priority);
+        if (setsockopt(socketFd, SOL_SOCKET, SO_PRIORITY, &socketPriority, sizeof(socketPriority)) < 0) {
+            std::cerr << "setsockopt SO_PRIORITY failed with error: " << std::strerror(errno) << std::endl;
+        }
+    }
+
+    bool LinuxTransport::enableKernelTimestamps(bool hardware, const std::string& interfaceName) {
+        kernelTimestamps = true;
+        hardwareTimestamps = hardware;
+        timestampInterface = interfaceName;
+        return !initialized || applyTimestamping();
+    }
+
+    bool LinuxTransport::applyTimestamping() {
+        if (hardwareTimestamps && !timestampInterface.empty()) {
+            // Ask the driver to timestamp every received packet; many NICs or VMs do not support it.
+            hwtstamp_config config{};
+            config.tx_type = HWTSTAMP_TX_OFF;
+            config.rx_filter = HWTSTAMP_FILTER_ALL;
+            ifreq request{};
+            std::strncpy(request.ifr_name, timestampInterface.c_str(), IFNAMSIZ - 1);
+            request.ifr_data = reinterpret_cast<char*>(&config);
+            if (ioctl(socketFd, SIOCSHWTSTAMP, &request) < 0) {
+                std::cerr << "SIOCSHWTSTAMP failed on " << timestampInterface << " with error: " << std::strerror(errno)
+                          << ", using software timestamps only." << std::endl;
+                hardwareTimestamps = false;
+            }
+        }
+
+        int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+        if (hardwareTimestamps) {
+            flags |= SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+        }
+        if (setsockopt(socketFd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) < 0) {
+            std::cerr << "setsockopt SO_TIMESTAMPING failed with error: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void LinuxTransport::enableSegmentationOffload(bool enabled) {
+        segmentationOffload = enabled;
+        if (initialized) {
+            applyOffload();
+        }
+    }
+
+    void LinuxTransport::applyOffload() {
+        // Probe GSO once by setting a socket-wide segment size, then clear it again so that
+        // only the sends carrying a UDP_SEGMENT control message are segmented.
+        sendOffload = false;
+        if (segmentationOffload) {
+            int segmentSize = 1024;
+            if (setsockopt(socketFd, SOL_UDP, UDP_SEGMENT, &segmentSize, sizeof(segmentSize)) == 0) {
+                segmentSize = 0;
+                setsockopt(socketFd, SOL_UDP, UDP_SEGMENT, &segmentSize, sizeof(segmentSize));
+                sendOffload = true;
+            } else {
+                std::cerr << "setsockopt UDP_SEGMENT failed with error: " << std::strerror(errno)
+                          << ", sending one datagram per packet." << std::endl;
+            }
+        }
+
+        int option = segmentationOffload ? 1 : 0;
+        receiveOffload = false;
+        if (setsockopt(socketFd, SOL_UDP, UDP_GRO, &option, sizeof(option)) == 0) {
+            receiveOffload = segmentationOffload;
+        } else if (segmentationOffload) {
+            std::cerr << "setsockopt UDP_GRO failed with error: " << std::strerror(errno)
+                      << ", receiving one datagram at a time." << std::endl;
+        }
+        // A coalesced datagram can be as large as a full UDP payload.
+        receiveBuffer.resize(receiveOffload ? LINUX_MAX_UDP_PAYLOAD : 4096);
+    }
+
+    void LinuxTransport::set_broadcast_port(const int port) {
+        this->broadcastPort = port;
+    }
+
+} // namespace YunaProtocol
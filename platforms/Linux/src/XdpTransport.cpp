@@ -0,0 +1,690 @@
+//
+// XdpTransport.cpp
+//
+
+#include "XdpTransport.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream> // For error logging
+#include <linux/bpf.h>
+#include <linux/if_link.h>
+#include <linux/if_xdp.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef AF_XDP
+#define AF_XDP 44
+#endif
+#ifndef SOL_XDP
+#define SOL_XDP 283
+#endif
+
+namespace YunaProtocol {
+
+    namespace {
+        constexpr size_t ETHERNET_HEADER_SIZE = 14;
+        constexpr size_t IPV4_HEADER_SIZE = 20;
+        constexpr size_t UDP_HEADER_SIZE = 8;
+        constexpr size_t FRAME_HEADERS_SIZE = ETHERNET_HEADER_SIZE + IPV4_HEADER_SIZE + UDP_HEADER_SIZE;
+
+        uint32_t steadyMs() {
+            return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        long bpf(int command, bpf_attr& attr) {
+            return syscall(__NR_bpf, command, &attr, sizeof(attr));
+        }
+
+        // --- BPF instruction encoding ---
+
+        bpf_insn instruction(uint8_t code, uint8_t dst, uint8_t src, int16_t offset, int32_t immediate) {
+            bpf_insn insn{};
+            insn.code = code;
+            insn.dst_reg = dst;
+            insn.src_reg = src;
+            insn.off = offset;
+            insn.imm = immediate;
+            return insn;
+        }
+
+        // The 16 bits the program sees when loading two bytes in network order.
+        int32_t networkHalf(uint8_t high, uint8_t low) {
+            const uint8_t bytes[2] = {high, low};
+            uint16_t value;
+            std::memcpy(&value, bytes, sizeof(value));
+            return value;
+        }
+
+        uint16_t ipChecksum(const uint8_t* header, size_t length) {
+            uint32_t sum = 0;
+            for (size_t i = 0; i + 1 < length; i += 2) {
+                sum += static_cast<uint32_t>(header[i]) << 8 | header[i + 1];
+            }
+            while (sum >> 16) {
+                sum = (sum & 0xffff) + (sum >> 16);
+            }
+            return static_cast<uint16_t>(~sum);
+        }
+
+        uint32_t loadAcquire(const uint32_t* value) {
+            return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+        }
+
+        void storeRelease(uint32_t* value, uint32_t newValue) {
+            __atomic_store_n(value, newValue, __ATOMIC_RELEASE);
+        }
+    }
+
+    // --- Constructor & Destructor ---
+
+    XdpTransport::XdpTransport(std::string interfaceName, int port, uint32_t queueId, XdpAttachMode mode)
+        : interfaceName(std::move(interfaceName)), listeningPort(port), broadcastPort(port), queueId(queueId),
+          mode(mode) {
+    }
+
+    XdpTransport::~XdpTransport() {
+        release();
+    }
+
+    void XdpTransport::release() {
+        if (linkFd >= 0) {
+            close(linkFd); // Detaches the program.
+            linkFd = -1;
+        }
+        for (Ring* ring : {&fillRing, &completionRing, &rxRing, &txRing}) {
+            if (ring->mapping) {
+                munmap(ring->mapping, ring->mappingSize);
+                *ring = Ring{};
+            }
+        }
+        for (int* fd : {&xskFd, &programFd, &mapFd}) {
+            if (*fd >= 0) {
+                close(*fd);
+                *fd = -1;
+            }
+        }
+        if (umem) {
+            munmap(umem, umemSize);
+            umem = nullptr;
+        }
+        initialized = false;
+    }
+
+    // --- Interface Implementation ---
+
+    bool XdpTransport::initialize() {
+        release();
+        interfaceIndex = if_nametoindex(interfaceName.c_str());
+        if (interfaceIndex == 0) {
+            std::cerr << "Unknown interface " << interfaceName << std::endl;
+            return false;
+        }
+        if (!readInterfaceAddresses() || !createSocket() || !loadProgram()) {
+            release();
+            return false;
+        }
+
+        // 1. Attach the program, preferring the driver hook.
+        bool attached = false;
+        if (mode != XdpAttachMode::Generic) {
+            attached = nativeMode = attachProgram(XDP_FLAGS_DRV_MODE);
+        }
+        if (!attached && mode != XdpAttachMode::Native) {
+            attached = attachProgram(XDP_FLAGS_SKB_MODE);
+        }
+        if (!attached) {
+            std::cerr << "Failed to attach the XDP program to " << interfaceName << ": " << std::strerror(errno)
+                      << std::endl;
+            release();
+            return false;
+        }
+
+        // 2. Bind the socket to the queue, preferring zero-copy, which only the driver hook supports.
+        bool bound = false;
+        if (nativeMode) {
+            bound = zeroCopy = bindSocket(XDP_ZEROCOPY | XDP_USE_NEED_WAKEUP);
+        }
+        if (!bound) {
+            bound = bindSocket(XDP_COPY | XDP_USE_NEED_WAKEUP) || bindSocket(XDP_COPY);
+        }
+        if (!bound) {
+            std::cerr << "Failed to bind the AF_XDP socket to " << interfaceName << " queue " << queueId << ": "
+                      << std::strerror(errno) << std::endl;
+            release();
+            return false;
+        }
+
+        // 3. Point the program's queue slot at the socket.
+        bpf_attr attr{};
+        attr.map_fd = static_cast<uint32_t>(mapFd);
+        attr.key = reinterpret_cast<uint64_t>(&queueId);
+        attr.value = reinterpret_cast<uint64_t>(&xskFd);
+        if (bpf(BPF_MAP_UPDATE_ELEM, attr) < 0) {
+            std::cerr << "Failed to register the AF_XDP socket in the XSKMAP: " << std::strerror(errno) << std::endl;
+            release();
+            return false;
+        }
+
+        // 4. Ask running peers to announce themselves instead of waiting for the discovery cycle.
+        joinSchedule.start(steadyMs(), clientID ^ static_cast<uint32_t>(getpid()) << 16 ^ steadyMs());
+
+        initialized = true;
+        std::cout << "XdpTransport initialized successfully on " << interfaceName << " queue " << queueId << " port "
+                  << listeningPort << " (" << (nativeMode ? "native" : "generic") << " mode, "
+                  << (zeroCopy ? "zero-copy" : "copy") << ")." << std::endl;
+        return true;
+    }
+
+    bool XdpTransport::readInterfaceAddresses() {
+        int fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd < 0) {
+            return false;
+        }
+        ifreq request{};
+        std::strncpy(request.ifr_name, interfaceName.c_str(), IFNAMSIZ - 1);
+        if (ioctl(fd, SIOCGIFHWADDR, &request) < 0) {
+            std::cerr << "SIOCGIFHWADDR failed on " << interfaceName << ": " << std::strerror(errno) << std::endl;
+            close(fd);
+            return false;
+        }
+        std::memcpy(localMac, request.ifr_hwaddr.sa_data, sizeof(localMac));
+        if (ioctl(fd, SIOCGIFADDR, &request) == 0) {
+            localIp = reinterpret_cast<sockaddr_in*>(&request.ifr_addr)->sin_addr.s_addr;
+        } else {
+            std::cerr << interfaceName << " has no IPv4 address, sending from 0.0.0.0." << std::endl;
+        }
+        close(fd);
+        return true;
+    }
+
+    bool XdpTransport::createSocket() {
+        xskFd = socket(AF_XDP, SOCK_RAW, 0);
+        if (xskFd < 0) {
+            std::cerr << "AF_XDP socket failed with error: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        // 1. Register the frame pool.
+        umemSize = static_cast<size_t>(frameSize) * frameCount;
+        void* address = mmap(nullptr, umemSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (address == MAP_FAILED) {
+            std::cerr << "Failed to allocate the UMEM: " << std::strerror(errno) << std::endl;
+            umemSize = 0;
+            return false;
+        }
+        umem = static_cast<uint8_t*>(address);
+        xdp_umem_reg registration{};
+        registration.addr = reinterpret_cast<uint64_t>(umem);
+        registration.len = umemSize;
+        registration.chunk_size = frameSize;
+        registration.headroom = 0;
+        if (setsockopt(xskFd, SOL_XDP, XDP_UMEM_REG, &registration, sizeof(registration)) < 0) {
+            std::cerr << "XDP_UMEM_REG failed with error: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        // 2. Size and map the four rings.
+        for (int option : {XDP_UMEM_FILL_RING, XDP_UMEM_COMPLETION_RING, XDP_RX_RING, XDP_TX_RING}) {
+            if (setsockopt(xskFd, SOL_XDP, option, &ringSize, sizeof(ringSize)) < 0) {
+                std::cerr << "Sizing an AF_XDP ring failed with error: " << std::strerror(errno) << std::endl;
+                return false;
+            }
+        }
+        xdp_mmap_offsets offsets{};
+        socklen_t offsetsSize = sizeof(offsets);
+        if (getsockopt(xskFd, SOL_XDP, XDP_MMAP_OFFSETS, &offsets, &offsetsSize) < 0) {
+            std::cerr << "XDP_MMAP_OFFSETS failed with error: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        if (!mapRing(fillRing, XDP_UMEM_PGOFF_FILL_RING, &offsets.fr, sizeof(uint64_t)) ||
+            !mapRing(completionRing, XDP_UMEM_PGOFF_COMPLETION_RING, &offsets.cr, sizeof(uint64_t)) ||
+            !mapRing(rxRing, XDP_PGOFF_RX_RING, &offsets.rx, sizeof(xdp_desc)) ||
+            !mapRing(txRing, XDP_PGOFF_TX_RING, &offsets.tx, sizeof(xdp_desc))) {
+            std::cerr << "Mapping an AF_XDP ring failed with error: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        // 3. Hand the receive half of the pool to the kernel, keep the other half for sending.
+        uint32_t receiveFrames = std::min(frameCount / 2, ringSize);
+        auto* fill = static_cast<uint64_t*>(fillRing.descriptors);
+        for (uint32_t i = 0; i < receiveFrames; ++i) {
+            fill[i & fillRing.mask] = static_cast<uint64_t>(i) * frameSize;
+        }
+        storeRelease(fillRing.producer, *fillRing.producer + receiveFrames);
+        freeTxFrames.clear();
+        for (uint32_t i = frameCount / 2; i < frameCount; ++i) {
+            freeTxFrames.push_back(static_cast<uint64_t>(i) * frameSize);
+        }
+        return true;
+    }
+
+    bool XdpTransport::mapRing(Ring& ring, uint64_t offset, const void* ringOffsets, size_t descriptorSize) {
+        xdp_ring_offset layout{};
+        std::memcpy(&layout, ringOffsets, sizeof(layout));
+        size_t size = layout.desc + ringSize * descriptorSize;
+        void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, xskFd,
+                             static_cast<off_t>(offset));
+        if (address == MAP_FAILED) {
+            return false;
+        }
+        auto* base = static_cast<uint8_t*>(address);
+        ring.mapping = address;
+        ring.mappingSize = size;
+        ring.producer = reinterpret_cast<uint32_t*>(base + layout.producer);
+        ring.consumer = reinterpret_cast<uint32_t*>(base + layout.consumer);
+        ring.flags = reinterpret_cast<uint32_t*>(base + layout.flags);
+        ring.descriptors = base + layout.desc;
+        ring.mask = ringSize - 1;
+        return true;
+    }
+
+    bool XdpTransport::loadProgram() {
+        bpf_attr attr{};
+        attr.map_type = BPF_MAP_TYPE_XSKMAP;
+        attr.key_size = sizeof(uint32_t);
+        attr.value_size = sizeof(uint32_t);
+        attr.max_entries = queueId + 1;
+        mapFd = static_cast<int>(bpf(BPF_MAP_CREATE, attr));
+        if (mapFd < 0) {
+            std::cerr << "Creating the XSKMAP failed with error: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        // Redirects unfragmented IPv4 UDP datagrams for our port into the socket of their queue,
+        // passes everything else to the kernel stack. Jumps target PASS, the last two instructions.
+        const int16_t PASS = 23;
+        const uint16_t port = htons(static_cast<uint16_t>(listeningPort));
+        const bpf_insn program[] = {
+            instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_6, BPF_REG_1, 0, 0),                  // r6 = ctx
+            instruction(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_2, BPF_REG_1, 0, 0),                    // r2 = data
+            instruction(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_3, BPF_REG_1, 4, 0),                    // r3 = data_end
+            instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_4, BPF_REG_2, 0, 0),
+            instruction(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_4, 0, 0, FRAME_HEADERS_SIZE),
+            instruction(BPF_JMP | BPF_JGT | BPF_X, BPF_REG_4, BPF_REG_3, PASS - 6, 0),             // too short
+            instruction(BPF_LDX | BPF_MEM | BPF_H, BPF_REG_5, BPF_REG_2, 12, 0),
+            instruction(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_5, 0, PASS - 8, networkHalf(0x08, 0x00)), // IPv4
+            instruction(BPF_LDX | BPF_MEM | BPF_B, BPF_REG_5, BPF_REG_2, 14, 0),
+            instruction(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_5, 0, PASS - 10, 0x45),                // no options
+            instruction(BPF_LDX | BPF_MEM | BPF_B, BPF_REG_5, BPF_REG_2, 23, 0),
+            instruction(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_5, 0, PASS - 12, IPPROTO_UDP),
+            instruction(BPF_LDX | BPF_MEM | BPF_H, BPF_REG_5, BPF_REG_2, 20, 0),
+            instruction(BPF_ALU64 | BPF_AND | BPF_K, BPF_REG_5, 0, 0, networkHalf(0x3f, 0xff)),
+            instruction(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_5, 0, PASS - 15, 0),                   // fragment
+            instruction(BPF_LDX | BPF_MEM | BPF_H, BPF_REG_5, BPF_REG_2, 36, 0),
+            instruction(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_5, 0, PASS - 17, port),                // dst port
+            instruction(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_2, BPF_REG_6, 16, 0),                   // rx_queue_index
+            instruction(BPF_LD | BPF_DW | BPF_IMM, BPF_REG_1, BPF_PSEUDO_MAP_FD, 0, mapFd),
+            instruction(0, 0, 0, 0, 0),
+            instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_3, 0, 0, XDP_PASS),                   // if no socket
+            instruction(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_redirect_map),
+            instruction(BPF_JMP | BPF_EXIT, 0, 0, 0, 0),
+            instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_0, 0, 0, XDP_PASS),                   // PASS
+            instruction(BPF_JMP | BPF_EXIT, 0, 0, 0, 0),
+        };
+        static const char license[] = "Dual BSD/GPL";
+        char log[4096] = {};
+
+        attr = bpf_attr{};
+        attr.prog_type = BPF_PROG_TYPE_XDP;
+        attr.expected_attach_type = BPF_XDP;
+        attr.insns = reinterpret_cast<uint64_t>(program);
+        attr.insn_cnt = sizeof(program) / sizeof(program[0]);
+        attr.license = reinterpret_cast<uint64_t>(license);
+        attr.log_buf = reinterpret_cast<uint64_t>(log);
+        attr.log_size = sizeof(log);
+        attr.log_level = 1;
+        programFd = static_cast<int>(bpf(BPF_PROG_LOAD, attr));
+        if (programFd < 0) {
+            std::cerr << "Loading the XDP program failed with error: " << std::strerror(errno) << "\n" << log
+                      << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool XdpTransport::attachProgram(uint32_t flags) {
+        bpf_attr attr{};
+        attr.link_create.prog_fd = static_cast<uint32_t>(programFd);
+        attr.link_create.target_ifindex = interfaceIndex;
+        attr.link_create.attach_type = BPF_XDP;
+        attr.link_create.flags = flags;
+        linkFd = static_cast<int>(bpf(BPF_LINK_CREATE, attr));
+        return linkFd >= 0;
+    }
+
+    bool XdpTransport::bindSocket(uint16_t flags) {
+        sockaddr_xdp address{};
+        address.sxdp_family = AF_XDP;
+        address.sxdp_flags = flags;
+        address.sxdp_ifindex = interfaceIndex;
+        address.sxdp_queue_id = queueId;
+        return bind(xskFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    }
+
+    void XdpTransport::loop() {
+        auto forward = [this](const PacketView& packet) {
+            if (viewCallback) {
+                viewCallback(packet);
+            } else if (callback) {
+                callback(packet.toPacket());
+            }
+        };
+        poll(forward);
+    }
+
+    void XdpTransport::broadcastDiscoveryIfDue() {
+        // Broadcast Discovery Peer Packet
+        auto now = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastDiscoveryBroadcast);
+
+        bool joining = joinSchedule.due(steadyMs());
+        if (joining || elapsed.count() > XDP_DISCOVERY_INTERVAL) {
+            lastDiscoveryBroadcast = now;
+            PacketView discoveryPacket;
+            discoveryPacket.header.protocolVersion = PROTOCOL_VERSION;
+            discoveryPacket.header.packetType = DISCOVERY_PEER;
+            discoveryPacket.header.sourceId = clientID;
+            discoveryPacket.header.payloadLength = 0; // No payload for discovery
+            if (joining) {
+                discoveryPacket.header.flags |= PACKET_FLAG_JOIN; // Peers reply with the peers they know
+            }
+
+            setTrafficClass(PriorityClass::Control); // Not the class of whatever data went out last.
+            if (!broadcast(discoveryPacket)) {
+                std::cerr << "Failed to broadcast discovery packet." << std::endl;
+            }
+        }
+    }
+
+    uint32_t XdpTransport::beginReceive() {
+        {
+            std::lock_guard<std::mutex> lock(txMutex);
+            reclaimCompletions();
+        }
+
+        // In copy mode with need-wakeup, the kernel only refills from the fill ring when asked to.
+        if (loadAcquire(fillRing.flags) & XDP_RING_NEED_WAKEUP) {
+            recvfrom(xskFd, nullptr, 0, MSG_DONTWAIT, nullptr, nullptr);
+        }
+
+        uint32_t available = loadAcquire(rxRing.producer) - *rxRing.consumer;
+        return std::min(available, batchSize);
+    }
+
+    bool XdpTransport::acceptFrame(uint32_t index, PacketView& packet) {
+        auto* descriptors = static_cast<const xdp_desc*>(rxRing.descriptors);
+        const xdp_desc& descriptor = descriptors[(*rxRing.consumer + index) & rxRing.mask];
+        const uint8_t* frame = umem + descriptor.addr;
+        size_t length = descriptor.len;
+
+        // The program only redirects IPv4 UDP without options, but check the lengths it did not.
+        if (length < FRAME_HEADERS_SIZE) {
+            droppedFrames++;
+            return false;
+        }
+        const uint8_t* ip = frame + ETHERNET_HEADER_SIZE;
+        const uint8_t* udp = ip + IPV4_HEADER_SIZE;
+        size_t udpLength = static_cast<size_t>(udp[4]) << 8 | udp[5];
+        if (udpLength < UDP_HEADER_SIZE || FRAME_HEADERS_SIZE - UDP_HEADER_SIZE + udpLength > length) {
+            droppedFrames++;
+            return false;
+        }
+        const uint8_t* data = udp + UDP_HEADER_SIZE;
+        size_t size = udpLength - UDP_HEADER_SIZE;
+        tapFrame(FrameDirection::Received, data, size);
+
+        DecodeStatus status = packet.decode(data, size);
+        if (status != DecodeStatus::Ok) {
+            if (status == DecodeStatus::ChecksumMismatch) {
+                corruptedPackets++;
+            }
+            droppedFrames++;
+            return false;
+        }
+
+        uint32_t sourceId = packet.header.sourceId;
+        if (sourceId == clientID) { return false; }
+        Endpoint endpoint{};
+        std::memcpy(endpoint.mac, frame + 6, sizeof(endpoint.mac));
+        std::memcpy(&endpoint.ip, ip + 12, sizeof(endpoint.ip));
+        std::memcpy(&endpoint.port, udp, sizeof(endpoint.port));
+        bool joining = packet.header.packetType == DISCOVERY_PEER && (packet.header.flags & PACKET_FLAG_JOIN);
+        bool discovered;
+        {
+            std::lock_guard<std::mutex> lock(txMutex);
+            // A known peer that joins again has restarted, possibly at another address.
+            discovered = joining ? clients.insert_or_assign(sourceId, endpoint).second
+                                 : clients.try_emplace(sourceId, endpoint).second;
+        }
+        if (discovered) {
+            char ipStr[INET_ADDRSTRLEN];
+            inet_ntop(AF_INET, &endpoint.ip, ipStr, INET_ADDRSTRLEN);
+            std::cout << "New client discovered with ID, addr: " << sourceId << " "
+                      << std::string(ipStr) + ":" + std::to_string(ntohs(endpoint.port)) << std::endl;
+        }
+        if (discovered || joining) {
+            notifyPeerDiscovered(sourceId); // Outside the lock: the listener sends.
+        }
+        if (joining) {
+            answerJoin(sourceId);
+        } else if (packet.header.packetType == DISCOVERY_REPLY) {
+            // Listed peers are reached once their own frames reveal their MAC, so only end the burst.
+            joinSchedule.onReply();
+            return false;
+        }
+        return packet.header.packetType != DISCOVERY_PEER;
+    }
+
+    void XdpTransport::answerJoin(uint32_t joinerId) {
+        uint8_t entries[MAX_PEERS_PER_REPLY * PEER_ENTRY_SIZE];
+        size_t size = 0;
+        std::unique_lock<std::mutex> lock(txMutex);
+        for (const auto& [id, endpoint] : clients) {
+            if (id == joinerId) continue;
+            if (size == sizeof(entries)) break;
+            PeerAddress peer;
+            peer.clientId = id;
+            peer.ipv4 = ntohl(endpoint.ip);
+            peer.port = ntohs(endpoint.port);
+            writePeerEntry(peer, entries + size);
+            size += PEER_ENTRY_SIZE;
+        }
+
+        PacketView reply;
+        reply.header.packetType = DISCOVERY_REPLY;
+        reply.header.sourceId = clientID;
+        reply.header.payloadLength = static_cast<uint16_t>(size);
+        reply.payload = entries;
+        lock.unlock();
+        setTrafficClass(PriorityClass::Control);
+        sendTo(joinerId, reply);
+    }
+
+    void XdpTransport::endReceive(uint32_t frames) {
+        auto* descriptors = static_cast<const xdp_desc*>(rxRing.descriptors);
+        auto* fill = static_cast<uint64_t*>(fillRing.descriptors);
+        uint32_t consumer = *rxRing.consumer;
+        uint32_t fillProducer = *fillRing.producer;
+        for (uint32_t i = 0; i < frames; ++i) {
+            uint64_t address = descriptors[(consumer + i) & rxRing.mask].addr;
+            // Every frame taken from the rx ring came from the fill ring, so there is always room to return it.
+            fill[(fillProducer + i) & fillRing.mask] = address - address % frameSize;
+        }
+        storeRelease(rxRing.consumer, consumer + frames);
+        storeRelease(fillRing.producer, fillProducer + frames);
+    }
+
+    void XdpTransport::reclaimCompletions() {
+        uint32_t consumer = *completionRing.consumer;
+        uint32_t completed = loadAcquire(completionRing.producer) - consumer;
+        auto* addresses = static_cast<const uint64_t*>(completionRing.descriptors);
+        for (uint32_t i = 0; i < completed; ++i) {
+            freeTxFrames.push_back(addresses[(consumer + i) & completionRing.mask]);
+        }
+        if (completed > 0) {
+            storeRelease(completionRing.consumer, consumer + completed);
+        }
+    }
+
+    bool XdpTransport::transmitFrame(const PacketView& packet, const Endpoint& destination) {
+        size_t datagramSize = packet.serializedSize();
+        size_t frameLength = FRAME_HEADERS_SIZE + datagramSize;
+        if (frameLength > frameSize) {
+            std::cerr << "Packet of size " << datagramSize << " does not fit in a UMEM frame." << std::endl;
+            return false;
+        }
+        if (freeTxFrames.empty()) {
+            reclaimCompletions();
+        }
+        uint32_t producer = *txRing.producer;
+        if (freeTxFrames.empty() || producer - loadAcquire(txRing.consumer) > txRing.mask) {
+            return false; // Transmit backlog full.
+        }
+        uint64_t address = freeTxFrames.back();
+        freeTxFrames.pop_back();
+
+        uint8_t* frame = umem + address;
+        // Ethernet
+        std::memcpy(frame, destination.mac, 6);
+        std::memcpy(frame + 6, localMac, 6);
+        frame[12] = 0x08;
+        frame[13] = 0x00;
+        // IPv4
+        uint8_t* ip = frame + ETHERNET_HEADER_SIZE;
+        uint16_t ipLength = static_cast<uint16_t>(IPV4_HEADER_SIZE + UDP_HEADER_SIZE + datagramSize);
+        std::memset(ip, 0, IPV4_HEADER_SIZE);
+        ip[0] = 0x45;
+        ip[1] = typeOfService;
+        ip[2] = static_cast<uint8_t>(ipLength >> 8);
+        ip[3] = static_cast<uint8_t>(ipLength);
+        ip[6] = 0x40; // Don't fragment
+        ip[8] = 64; // TTL
+        ip[9] = IPPROTO_UDP;
+        std::memcpy(ip + 12, &localIp, 4);
+        std::memcpy(ip + 16, &destination.ip, 4);
+        uint16_t checksum = ipChecksum(ip, IPV4_HEADER_SIZE);
+        ip[10] = static_cast<uint8_t>(checksum >> 8);
+        ip[11] = static_cast<uint8_t>(checksum);
+        // UDP, without checksum as IPv4 allows.
+        uint8_t* udp = ip + IPV4_HEADER_SIZE;
+        uint16_t sourcePort = htons(static_cast<uint16_t>(listeningPort));
+        uint16_t udpLength = static_cast<uint16_t>(UDP_HEADER_SIZE + datagramSize);
+        std::memcpy(udp, &sourcePort, 2);
+        std::memcpy(udp + 2, &destination.port, 2);
+        udp[4] = static_cast<uint8_t>(udpLength >> 8);
+        udp[5] = static_cast<uint8_t>(udpLength);
+        udp[6] = 0;
+        udp[7] = 0;
+        // Serialized straight into the frame the NIC will send.
+        packet.serialize(udp + UDP_HEADER_SIZE, datagramSize);
+
+        auto* descriptors = static_cast<xdp_desc*>(txRing.descriptors);
+        descriptors[producer & txRing.mask] = xdp_desc{address, static_cast<uint32_t>(frameLength), 0};
+        storeRelease(txRing.producer, producer + 1);
+
+        // Copy mode always needs a kick; zero-copy only when the driver asks for it.
+        if (!zeroCopy || (loadAcquire(txRing.flags) & XDP_RING_NEED_WAKEUP)) {
+            if (sendto(xskFd, nullptr, 0, MSG_DONTWAIT, nullptr, 0) < 0 && errno != EAGAIN && errno != EBUSY &&
+                errno != ENOBUFS) {
+                std::cerr << "AF_XDP transmit kick failed with error: " << std::strerror(errno) << std::endl;
+            }
+        }
+        tapFrame(FrameDirection::Sent, udp + UDP_HEADER_SIZE, datagramSize);
+        return true;
+    }
+
+    bool XdpTransport::send(const Packet& packet) {
+        return send(packet.view());
+    }
+
+    bool XdpTransport::send(const PacketView& packet) {
+        if (!initialized) return false;
+        std::lock_guard<std::mutex> lock(txMutex);
+
+        bool sent = true;
+        for (const auto& [clientId, endpoint] : clients) {
+            if (!transmitFrame(packet, endpoint)) {
+                std::cerr << "AF_XDP send failed for client " << clientId << std::endl;
+                sent = false;
+            }
+        }
+        return sent;
+    }
+
+    bool XdpTransport::sendTo(uint32_t clientId, const Packet& packet) {
+        return sendTo(clientId, packet.view());
+    }
+
+    bool XdpTransport::sendTo(uint32_t clientId, const PacketView& packet) {
+        if (!initialized) return false;
+        std::lock_guard<std::mutex> lock(txMutex);
+
+        auto client = clients.find(clientId);
+        if (client == clients.end()) {
+            return false;
+        }
+        return transmitFrame(packet, client->second);
+    }
+
+    bool XdpTransport::broadcast(const Packet& packet) {
+        return broadcast(packet.view());
+    }
+
+    bool XdpTransport::broadcast(const PacketView& packet) {
+        if (!initialized) return false;
+
+        Endpoint everyone{};
+        std::memset(everyone.mac, 0xff, sizeof(everyone.mac));
+        everyone.ip = INADDR_BROADCAST;
+        everyone.port = htons(static_cast<uint16_t>(broadcastPort));
+        std::lock_guard<std::mutex> lock(txMutex);
+        return transmitFrame(packet, everyone);
+    }
+
+    std::vector<uint32_t> XdpTransport::listConnectedClients() {
+        std::lock_guard<std::mutex> lock(txMutex);
+        std::vector<uint32_t> clientIds;
+        clientIds.reserve(clients.size());
+        for (const auto& [clientId, endpoint] : clients) {
+            clientIds.push_back(clientId);
+        }
+        return clientIds;
+    }
+
+    void XdpTransport::setTrafficClass(PriorityClass priority) {
+        typeOfService = static_cast<uint8_t>(dscpForPriority(priority) << 2);
+    }
+
+    void XdpTransport::registerPacketViewCallback(const PacketViewCallback& callback) {
+        viewCallback = callback;
+    }
+
+    void XdpTransport::set_batch_size(uint32_t frames) {
+        batchSize = frames == 0 ? 1 : frames;
+    }
+
+    void XdpTransport::set_broadcast_port(const int port) {
+        this->broadcastPort = port;
+    }
+
+    bool XdpTransport::isNativeMode() const {
+        return nativeMode;
+    }
+
+    bool XdpTransport::isZeroCopy() const {
+        return zeroCopy;
+    }
+
+    uint64_t XdpTransport::getDroppedFrameCount() const {
+        return droppedFrames;
+    }
+
+} // namespace YunaProtocol
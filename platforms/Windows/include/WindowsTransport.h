@@ -10,10 +10,13 @@
 #define WINDOWS_DISCOVERY_INTERVAL 5000
 #include <winsock2.h>
 #include <ws2tcpip.h>
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <vector>
 
 // --- Project Includes ---
+#include "Discovery.h"
 #include "Transport.h" // Base class interface
 #include <chrono>
 
@@ -29,7 +32,7 @@ namespace YunaProtocol {
      *
      * This class handles the low-level networking details for sending and receiving
      * YunaProtocol::Packet objects over a UDP socket. It supports unicast, broadcast,
-     * and automatic discovery of clients.
+     * and automatic discovery of clients. Sending is safe from any thread while loop() runs.
      */
     class WindowsTransport : public YunaTransport {
     public:
@@ -57,6 +60,8 @@ namespace YunaProtocol {
          * 3. Binds the socket to the specified port and any available IP address.
          * 4. Enables broadcasting on the socket.
          * 5. Sets the socket to non-blocking mode to prevent the loop() from halting execution.
+         * 6. Schedules a burst of joins, sent by the next loop() calls, that running peers answer
+         *    with the peers they know.
          */
         bool initialize() override;
 
@@ -73,6 +78,15 @@ namespace YunaProtocol {
          */
         bool send(const Packet& packet) override;
 
+        /**
+         * @brief Sends a packet to a single known client.
+         *
+         * @param clientId The destination client ID.
+         * @param packet The packet to send.
+         * @return True if the packet was sent, false if the client is unknown or an error occurred.
+         */
+        bool sendTo(uint32_t clientId, const Packet& packet) override;
+
         /**
          * @brief Receives incoming packets and invokes the registered callback.
          *
@@ -99,12 +113,23 @@ namespace YunaProtocol {
 
 
 
+        /**
+         * @brief Sets IP_TOS for the packets sent from now on, when the class changes.
+         *
+         * Windows only honours IP_TOS when the system policy allows it; otherwise this is a no-op.
+         */
+        void setTrafficClass(PriorityClass priority) override;
+
         void set_broadcast_port(int port)  ;
 
 
         ;
 
     private:
+        void answerJoin(uint32_t joinerId);
+
+        void addListedPeers(const Packet& reply);
+
         // --- Member Variables ---
 
         SOCKET listenSocket;                                  // The primary socket for all network operations.
@@ -112,8 +137,11 @@ namespace YunaProtocol {
         int listeningPort;                                           // The port number for listening
         int broadcastPort;                                            // The port number for  broadcasting.
         std::map<uint32_t, sockaddr_in> clients;              // A map to store the addresses of known clients [ClientID -> Address].
+        std::mutex clientsMutex;                              // Guards clients: sends may come from other threads.
         bool initialized;
+        std::atomic<int> currentTrafficClass{-1};             // PriorityClass applied to the socket, -1 if none yet.
         std::chrono::steady_clock::time_point lastDiscoveryBroadcast{};// Flag to track if initialize() has been called successfully.
+        JoinSchedule joinSchedule;                            // Discovery burst sent after initialize().
     };
 
 } // namespace YunaProtocol
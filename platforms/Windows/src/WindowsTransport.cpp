@@ -8,6 +8,13 @@
 
 namespace YunaProtocol {
 
+    namespace {
+        uint32_t steadyMs() {
+            return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+    }
+
     // --- Constructor & Destructor ---
 
     WindowsTransport::WindowsTransport(int port)
@@ -76,6 +83,9 @@ namespace YunaProtocol {
             return false;
         }
 
+        // 6. Ask running peers for the peers they know instead of waiting for the discovery cycle.
+        joinSchedule.start(steadyMs(), clientID ^ static_cast<uint32_t>(GetCurrentProcessId()) << 16 ^ steadyMs());
+
         initialized = true;
         std::cout << "WindowsTransport initialized successfully on port " << this->listeningPort << "." << std::endl;
         return true;
@@ -87,19 +97,24 @@ namespace YunaProtocol {
         auto now = std::chrono::steady_clock::now();
         auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastDiscoveryBroadcast);
 
-        if (elapsed.count() > WINDOWS_DISCOVERY_INTERVAL) { // Broadcast only once per second
+        bool joining = joinSchedule.due(steadyMs());
+        if (joining || elapsed.count() > WINDOWS_DISCOVERY_INTERVAL) { // Broadcast only once per second
 
 
 
             lastDiscoveryBroadcast = now;
             Packet discoveryPacket;
-            discoveryPacket.header.protocolVersion = 1;
+            discoveryPacket.header.protocolVersion = PROTOCOL_VERSION;
             discoveryPacket.header.packetType = DISCOVERY_PEER;
             discoveryPacket.header.sourceId = clientID; // Use 0 or a specific ID for discovery
             discoveryPacket.header.payloadLength = 0; // No payload for discovery
-            discoveryPacket.header.channelPassword = 0; // No password for discovery
+            discoveryPacket.header.nonce = 0; // Discovery is never encrypted
+            if (joining) {
+                discoveryPacket.header.flags |= PACKET_FLAG_JOIN; // Peers reply with the peers they know
+            }
 
             // Broadcast the discovery packet to find peers
+            setTrafficClass(PriorityClass::Control); // Not the class of whatever data went out last.
             if (!broadcast(discoveryPacket)) {
                 std::cerr << "Failed to broadcast discovery packet." << std::endl;
             } else {
@@ -129,21 +144,34 @@ namespace YunaProtocol {
 
         if (bytesReceived > 0) {
             // Data was received, now process it.
+            tapFrame(FrameDirection::Received, reinterpret_cast<uint8_t*>(buffer), bytesReceived);
             Packet receivedPacket;
-            if (receivedPacket.deserialize(reinterpret_cast<uint8_t*>(buffer), bytesReceived)) {
+            DecodeStatus status = receivedPacket.decode(reinterpret_cast<uint8_t*>(buffer), bytesReceived);
+            if (status == DecodeStatus::Ok) {
                 if (receivedPacket.header.sourceId == clientID){return;}
                 //uint32_t clientId = receivedPacket.header.sourceId;
-                if (receivedPacket.header.packetType == DISCOVERY_PEER || clients.find(receivedPacket.header.sourceId) == clients.end() ) { // or sender is not in clients
-                    // Handle discovery packet logic here if needed.
-                    // /std::cout << "Discovery packet received from client ID: " << receivedPacket.header.sourceId << std::endl;
-                    // CHeck if not in clients map then add it
-                    if (clients.find(receivedPacket.header.sourceId) == clients.end()) {
-                        char ipStr[INET_ADDRSTRLEN];
-                        inet_ntop(AF_INET, &(senderAddr.sin_addr), ipStr, INET_ADDRSTRLEN);
-                        std::cout << "New client discovered with ID, addr: " << receivedPacket.header.sourceId << " " << std::string(ipStr) + ":" + std::to_string(ntohs(senderAddr.sin_port))<< std::endl;
-                        // Add the new client to the clients map.
-                        clients[receivedPacket.header.sourceId] = senderAddr;
-                    }
+                // Add the sender to the clients map if it is not in it yet.
+                bool joining = receivedPacket.header.packetType == DISCOVERY_PEER && (receivedPacket.header.flags & PACKET_FLAG_JOIN);
+                bool discovered;
+                {
+                    std::lock_guard<std::mutex> lock(clientsMutex);
+                    // A known peer that joins again has restarted, possibly at another address.
+                    discovered = joining ? clients.insert_or_assign(receivedPacket.header.sourceId, senderAddr).second
+                                         : clients.try_emplace(receivedPacket.header.sourceId, senderAddr).second;
+                }
+                if (discovered) {
+                    char ipStr[INET_ADDRSTRLEN];
+                    inet_ntop(AF_INET, &(senderAddr.sin_addr), ipStr, INET_ADDRSTRLEN);
+                    std::cout << "New client discovered with ID, addr: " << receivedPacket.header.sourceId << " " << std::string(ipStr) + ":" + std::to_string(ntohs(senderAddr.sin_port))<< std::endl;
+                }
+                if (discovered || joining) {
+                    notifyPeerDiscovered(receivedPacket.header.sourceId); // Outside the lock: the listener sends.
+                }
+                if (joining) {
+                    answerJoin(receivedPacket.header.sourceId);
+                } else if (receivedPacket.header.packetType == DISCOVERY_REPLY) {
+                    addListedPeers(receivedPacket);
+                    return;
                 }
                 if (receivedPacket.header.packetType != DISCOVERY_PEER) {
 
@@ -156,6 +184,9 @@ namespace YunaProtocol {
                         callback(receivedPacket);
                     }
                 }
+            } else if (status == DecodeStatus::ChecksumMismatch) {
+                corruptedPackets++;
+                std::cerr << "Dropped corrupted packet of size " << bytesReceived << std::endl;
             } else {
                  std::cerr << "Failed to deserialize packet of size " << bytesReceived << std::endl;
             }
@@ -169,6 +200,48 @@ namespace YunaProtocol {
         }
     }
 
+    void WindowsTransport::answerJoin(uint32_t joinerId) {
+        Packet reply;
+        reply.header.packetType = DISCOVERY_REPLY;
+        reply.header.sourceId = clientID;
+        {
+            std::lock_guard<std::mutex> lock(clientsMutex);
+            for (const auto& client_pair : clients) {
+                if (client_pair.first == joinerId) continue;
+                if (reply.payload.size() == MAX_PEERS_PER_REPLY * PEER_ENTRY_SIZE) break;
+                PeerAddress peer;
+                peer.clientId = client_pair.first;
+                peer.ipv4 = ntohl(client_pair.second.sin_addr.s_addr);
+                peer.port = ntohs(client_pair.second.sin_port);
+                reply.payload.resize(reply.payload.size() + PEER_ENTRY_SIZE);
+                writePeerEntry(peer, reply.payload.data() + reply.payload.size() - PEER_ENTRY_SIZE);
+            }
+        }
+        reply.header.payloadLength = static_cast<uint16_t>(reply.payload.size());
+        setTrafficClass(PriorityClass::Control);
+        sendTo(joinerId, reply);
+    }
+
+    void WindowsTransport::addListedPeers(const Packet& reply) {
+        joinSchedule.onReply();
+        for (size_t offset = 0; offset + PEER_ENTRY_SIZE <= reply.payload.size(); offset += PEER_ENTRY_SIZE) {
+            PeerAddress peer = readPeerEntry(reply.payload.data() + offset);
+            if (peer.clientId == clientID) continue;
+            sockaddr_in peerAddr{};
+            peerAddr.sin_family = AF_INET;
+            peerAddr.sin_addr.s_addr = htonl(peer.ipv4);
+            peerAddr.sin_port = htons(peer.port);
+            {
+                std::lock_guard<std::mutex> lock(clientsMutex);
+                if (!clients.try_emplace(peer.clientId, peerAddr).second) continue;
+            }
+            char ipStr[INET_ADDRSTRLEN];
+            inet_ntop(AF_INET, &(peerAddr.sin_addr), ipStr, INET_ADDRSTRLEN);
+            std::cout << "New client listed by " << reply.header.sourceId << " with ID, addr: " << peer.clientId << " " << std::string(ipStr) + ":" + std::to_string(peer.port) << std::endl;
+            notifyPeerDiscovered(peer.clientId);
+        }
+    }
+
     bool WindowsTransport::send(const Packet& packet) {
         if (!initialized) return false;
 
@@ -180,6 +253,7 @@ namespace YunaProtocol {
             return false;
         }
 
+        std::lock_guard<std::mutex> lock(clientsMutex);
         if (clients.empty()) {
             // Optional: Log if there are no clients to send to.
             // std::cout << "No clients connected, nothing to send." << std::endl;
@@ -204,6 +278,8 @@ namespace YunaProtocol {
                 std::cerr << "sendto failed for client " << client_pair.first
                           << " with error: " << WSAGetLastError() << std::endl;
                 // You might want to return false here or continue to send to other clients
+            } else {
+                tapFrame(FrameDirection::Sent, buffer.data(), buffer.size());
             }
         }
 
@@ -220,6 +296,35 @@ namespace YunaProtocol {
 
     }
 
+    bool WindowsTransport::sendTo(uint32_t clientId, const Packet& packet) {
+        if (!initialized) return false;
+
+        sockaddr_in clientAddr;
+        {
+            std::lock_guard<std::mutex> lock(clientsMutex);
+            auto client = clients.find(clientId);
+            if (client == clients.end()) {
+                return false;
+            }
+            clientAddr = client->second;
+        }
+
+        std::vector<uint8_t> buffer;
+        if (!packet.serialize(buffer)) {
+            std::cerr << "Failed to serialize packet for sending." << std::endl;
+            return false;
+        }
+
+        int bytesSent = sendto(listenSocket, (const char*)buffer.data(), static_cast<int>(buffer.size()), 0,
+                               (const sockaddr*)&clientAddr, sizeof(clientAddr));
+        if (bytesSent == SOCKET_ERROR) {
+            std::cerr << "sendto failed for client " << clientId << " with error: " << WSAGetLastError() << std::endl;
+            return false;
+        }
+        tapFrame(FrameDirection::Sent, buffer.data(), buffer.size());
+        return true;
+    }
+
     bool WindowsTransport::broadcast(const Packet& packet) {
         if (!initialized) return false;
 
@@ -243,11 +348,13 @@ namespace YunaProtocol {
             std::cerr << "broadcast sendto failed with error: " << WSAGetLastError() << std::endl;
             return false;
         }
+        tapFrame(FrameDirection::Sent, buffer.data(), buffer.size());
 
         return bytesSent == buffer.size();
     }
 
     std::vector<uint32_t> WindowsTransport::listConnectedClients() {
+        std::lock_guard<std::mutex> lock(clientsMutex);
         std::vector<uint32_t> clientIds;
         // Reserve space for efficiency.
         clientIds.reserve(clients.size());
@@ -260,6 +367,18 @@ namespace YunaProtocol {
     }
 
 
+    void WindowsTransport::setTrafficClass(PriorityClass priority) {
+        // Exchanged, as loop() marks discovery traffic while other threads send data.
+        if (!initialized || currentTrafficClass.exchange(static_cast<int>(priority)) == static_cast<int>(priority)) return;
+
+        // The DSCP occupies the upper six bits of the TOS byte.
+        DWORD tos = dscpForPriority(priority) << 2;
+        if (setsockopt(listenSocket, IPPROTO_IP, IP_TOS, (const char*)&tos, sizeof(tos)) == SOCKET_ERROR) {
+            std::cerr << "setsockopt IP_TOS failed with error: " << WSAGetLastError() << std::endl;
+        }
+    }
+
+
     void WindowsTransport::set_broadcast_port(const int port)  {
         this->broadcastPort = port;
     }
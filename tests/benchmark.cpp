@@ -0,0 +1,263 @@
+//
+// Created by youss on 10/19/2026.
+//
+// Micro-benchmarks of the per-packet kernels, printed as cycles per byte and packets per second.
+// Cycles are time stamp counter ticks, which run at the nominal clock rather than the boosted one.
+// Run without arguments for every group, or name the groups to run, e.g. "YunaBenchmark crc32c".
+// Groups: crc32c, aead (ChaCha20-Poly1305 on every kernel this CPU has) and cipher (ChannelCipher).
+//
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "ChaCha20Poly1305.h"
+#include "ChannelCipher.h"
+#include "Checksum.h"
+#include "Packet.h"
+#include "YunaConfig.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define YUNA_BENCH_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define YUNA_BENCH_TSC 1
+#endif
+
+using namespace YunaProtocol;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // Header plus payload of a small telemetry packet, a mid-sized one and a full datagram.
+    const size_t PACKET_SIZES[] = {sizeof(PacketHeader) + 8, sizeof(PacketHeader) + 200,
+                                   sizeof(PacketHeader) + 520, sizeof(PacketHeader) + YUNA_MAX_PAYLOAD};
+
+    // Packets per batch, as a busy loop() hands them to sealBatch() and sendBatch().
+    constexpr size_t BATCH = 16;
+
+    constexpr int RUNS = 5;
+    constexpr auto RUN_TIME = std::chrono::milliseconds(40);
+
+    volatile uint32_t sink; // Keeps results alive so the measured work is not optimized away.
+
+    struct Measurement {
+        double nsPerCall = 0;
+        double cyclesPerCall = 0; // Time stamp counter ticks, 0 where there is none.
+    };
+
+    uint64_t cycleCounter() {
+#if defined(YUNA_BENCH_TSC)
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    /**
+     * @brief Times a call, keeping the fastest of several runs to filter out interruptions.
+     */
+    template<typename Body>
+    Measurement measure(Body &&body) {
+        size_t calls = 1;
+        // Grow the call count until a run lasts long enough to time.
+        while (true) {
+            auto start = Clock::now();
+            for (size_t i = 0; i < calls; ++i) {
+                body();
+            }
+            if (Clock::now() - start >= RUN_TIME / 4) {
+                break;
+            }
+            calls *= 2;
+        }
+        calls *= 4;
+        Measurement best;
+        for (int run = 0; run < RUNS; ++run) {
+            auto start = Clock::now();
+            uint64_t startCycles = cycleCounter();
+            for (size_t i = 0; i < calls; ++i) {
+                body();
+            }
+            uint64_t cycles = cycleCounter() - startCycles;
+            double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now() - start).count());
+            if (run == 0 || ns / calls < best.nsPerCall) {
+                best.nsPerCall = ns / calls;
+                best.cyclesPerCall = static_cast<double>(cycles) / calls;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * @brief Prints one result line.
+     * @param bytesPerCall Bytes processed by one call.
+     * @param packetsPerCall Packets processed by one call.
+     */
+    void report(const char *name, const char *variant, size_t packetSize, size_t batch,
+                size_t bytesPerCall, size_t packetsPerCall, const Measurement &m) {
+        double cyclesPerByte = m.cyclesPerCall / static_cast<double>(bytesPerCall);
+        double packetsPerSecond = 1e9 * static_cast<double>(packetsPerCall) / m.nsPerCall;
+        double gigabytesPerSecond = static_cast<double>(bytesPerCall) / m.nsPerCall;
+        std::printf("%-8s %-12s %6zu B x %-3zu %8.2f cyc/B %9.2f Mpkt/s %7.2f GB/s\n", name, variant,
+                    packetSize, batch, cyclesPerByte, packetsPerSecond / 1e6, gigabytesPerSecond);
+    }
+
+    void benchmarkCrc32c() {
+        std::vector<uint8_t> packet(PACKET_SIZES[3]);
+        for (size_t i = 0; i < packet.size(); ++i) {
+            packet[i] = static_cast<uint8_t>(i * 31 + 7);
+        }
+        if (crc32c(packet.data(), packet.size()) != crc32cTable(packet.data(), packet.size())) {
+            std::printf("crc32c     hardware and table results differ\n");
+        }
+        for (size_t size : PACKET_SIZES) {
+            if (crc32cIsHardwareAccelerated()) {
+                Measurement m = measure([&] { sink = crc32c(packet.data(), size); });
+                report("crc32c", "hardware", size, 1, size, 1, m);
+            }
+            Measurement m = measure([&] { sink = crc32cTable(packet.data(), size); });
+            report("crc32c", "table", size, 1, size, 1, m);
+        }
+    }
+
+    /**
+     * @brief ChaCha20-Poly1305 on each keystream kernel, one packet and a batch at a time.
+     *
+     * Sizes are the payload of each packet size, with its header as additional data. Opening
+     * decrypts in place, so every call first restores the ciphertext; that copy is included.
+     */
+    void benchmarkAead() {
+        const std::string detected = ChaCha20Poly1305::kernelName();
+        const uint8_t key[AEAD_KEY_SIZE] = {7};
+        const ChaCha20Poly1305 cipher(key);
+        const uint8_t header[sizeof(PacketHeader)] = {};
+        uint8_t nonces[BATCH][AEAD_NONCE_SIZE] = {};
+        for (size_t i = 0; i < BATCH; ++i) {
+            nonces[i][0] = static_cast<uint8_t>(i);
+        }
+
+        for (const char *kernel : {"avx2", "sse2", "neon", "scalar"}) {
+            if (!ChaCha20Poly1305::useKernel(kernel)) {
+                continue;
+            }
+            std::string sealName = std::string(kernel) + " seal";
+            std::string openName = std::string(kernel) + " open";
+            for (size_t size : PACKET_SIZES) {
+                size_t length = size - sizeof(PacketHeader);
+                std::vector<uint8_t> data(BATCH * length, 0x5a);
+                std::vector<uint8_t> tags(BATCH * AEAD_TAG_SIZE);
+                AeadMessage messages[BATCH];
+                for (size_t i = 0; i < BATCH; ++i) {
+                    messages[i] = {&cipher, nonces[i], header, sizeof(header), data.data() + i * length, length,
+                                   tags.data() + i * AEAD_TAG_SIZE};
+                }
+
+                Measurement m = measure([&] {
+                    cipher.seal(nonces[0], header, sizeof(header), data.data(), length, tags.data());
+                    sink = tags[0];
+                });
+                report("aead", sealName.c_str(), size, 1, length, 1, m);
+                m = measure([&] {
+                    sealBatch(messages, BATCH);
+                    sink = tags[0];
+                });
+                report("aead", sealName.c_str(), size, BATCH, BATCH * length, BATCH, m);
+
+                const std::vector<uint8_t> sealed = data;
+                bool authentic[BATCH];
+                m = measure([&] {
+                    std::memcpy(data.data(), sealed.data(), sealed.size());
+                    sink = static_cast<uint32_t>(openBatch(messages, BATCH, authentic));
+                });
+                if (sink != BATCH) {
+                    std::printf("aead     %s: sealed messages failed to open\n", kernel);
+                }
+                report("aead", openName.c_str(), size, BATCH, BATCH * length, BATCH, m);
+            }
+        }
+        ChaCha20Poly1305::useKernel(detected.c_str());
+    }
+
+    /**
+     * @brief ChannelCipher::seal() and open() on batches of DATA packets, with the default kernel.
+     *
+     * Sealing changes the packets, so every call first restores the plaintext batch; that copy is
+     * included. Opening runs the whole receive path, the replay check rejecting the repeats last.
+     */
+    void benchmarkChannelCipher() {
+        const uint8_t key[AEAD_KEY_SIZE] = {7};
+        ChannelCipher sender;
+        ChannelCipher receiver;
+        sender.setKey("bench", key);
+        sender.setSession(1);
+        receiver.setKey("bench", key);
+        std::string sealName = std::string(ChaCha20Poly1305::kernelName()) + " seal";
+        std::string openName = std::string(ChaCha20Poly1305::kernelName()) + " open";
+
+        for (size_t size : PACKET_SIZES) {
+            size_t length = size - sizeof(PacketHeader);
+            Packet plain;
+            plain.header.packetType = DATA;
+            plain.header.sourceId = 1;
+            std::strcpy(plain.header.channel, "bench");
+            plain.payload.assign(length, 0x5a);
+            plain.header.payloadLength = static_cast<uint16_t>(length);
+            std::vector<Packet> batch(BATCH, plain);
+            for (Packet &packet : batch) {
+                packet.payload.reserve(length + AEAD_TAG_SIZE);
+            }
+
+            Measurement m = measure([&] {
+                for (Packet &packet : batch) {
+                    packet.header = plain.header;
+                    packet.payload.assign(plain.payload.begin(), plain.payload.end());
+                }
+                sender.seal(batch.data(), batch.size());
+                sink = batch[0].payload[0];
+            });
+            report("cipher", sealName.c_str(), size, BATCH, BATCH * length, BATCH, m);
+
+            Packet opened;
+            opened.payload.reserve(length);
+            m = measure([&] {
+                for (const Packet &packet : batch) {
+                    sink = receiver.open(packet, opened);
+                }
+            });
+            report("cipher", openName.c_str(), size, BATCH, BATCH * length, BATCH, m);
+        }
+    }
+
+    struct Group {
+        const char *name;
+        void (*run)();
+    };
+
+    const Group GROUPS[] = {
+        {"crc32c", benchmarkCrc32c},
+        {"aead", benchmarkAead},
+        {"cipher", benchmarkChannelCipher},
+    };
+}
+
+int main(int argc, char *argv[]) {
+#if !defined(YUNA_BENCH_TSC)
+    std::printf("No cycle counter on this CPU: cyc/B reads 0, use the packet and byte rates.\n");
+#endif
+    for (const Group &group : GROUPS) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i) {
+            selected |= std::strcmp(argv[i], group.name) == 0;
+        }
+        if (selected) {
+            group.run();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,199 @@
+//
+// Created by youss on 10/19/2026.
+//
+// Checks ChaCha20-Poly1305 against the AEAD test vector of RFC 8439, section 2.8.2, with every
+// keystream kernel this CPU has, then checks that the kernels and sealBatch()/openBatch() produce
+// the same ciphertexts and tags as the scalar kernel for lengths that do not fill a block and for
+// batches that mix keys.
+//
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "ChaCha20Poly1305.h"
+
+using namespace YunaProtocol;
+
+namespace {
+    const char *const KERNELS[] = {"scalar", "sse2", "avx2", "neon"};
+    const size_t LENGTHS[] = {0, 1, 15, 16, 17, 63, 64, 65, 127, 129, 255, 257, 511, 1000, 1400};
+
+    int failures = 0;
+
+    void check(bool condition, const char *what, const char *kernel) {
+        if (!condition) {
+            std::printf("FAIL: %s (%s)\n", what, kernel);
+            failures++;
+        }
+    }
+
+    struct Sealed {
+        std::vector<uint8_t> data;
+        uint8_t tag[AEAD_TAG_SIZE];
+    };
+
+    /**
+     * @brief A message of the comparison runs: its key, nonce, additional data and plaintext.
+     */
+    struct Message {
+        size_t key;
+        uint8_t nonce[AEAD_NONCE_SIZE];
+        uint8_t aad[7];
+        std::vector<uint8_t> plaintext;
+    };
+
+    std::vector<Message> messages() {
+        std::vector<Message> result;
+        uint32_t seed = 0x9e3779b9;
+        auto next = [&seed] {
+            seed = seed * 1664525 + 1013904223;
+            return static_cast<uint8_t>(seed >> 24);
+        };
+        for (size_t i = 0; i < sizeof(LENGTHS) / sizeof(LENGTHS[0]); ++i) {
+            Message message;
+            message.key = i % 3;
+            for (uint8_t& byte : message.nonce) byte = next();
+            for (uint8_t& byte : message.aad) byte = next();
+            message.plaintext.resize(LENGTHS[i]);
+            for (uint8_t& byte : message.plaintext) byte = next();
+            result.push_back(message);
+        }
+        return result;
+    }
+
+    void rfc8439Vector(const char *kernel) {
+        const char *plaintext = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for "
+                                "the future, sunscreen would be it.";
+        const uint8_t aad[] = {0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7};
+        const uint8_t nonce[AEAD_NONCE_SIZE] = {0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47};
+        const uint8_t ciphertext[] = {
+            0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb, 0x7b, 0x86, 0xaf, 0xbc, 0x53, 0xef, 0x7e, 0xc2,
+            0xa4, 0xad, 0xed, 0x51, 0x29, 0x6e, 0x08, 0xfe, 0xa9, 0xe2, 0xb5, 0xa7, 0x36, 0xee, 0x62, 0xd6,
+            0x3d, 0xbe, 0xa4, 0x5e, 0x8c, 0xa9, 0x67, 0x12, 0x82, 0xfa, 0xfb, 0x69, 0xda, 0x92, 0x72, 0x8b,
+            0x1a, 0x71, 0xde, 0x0a, 0x9e, 0x06, 0x0b, 0x29, 0x05, 0xd6, 0xa5, 0xb6, 0x7e, 0xcd, 0x3b, 0x36,
+            0x92, 0xdd, 0xbd, 0x7f, 0x2d, 0x77, 0x8b, 0x8c, 0x98, 0x03, 0xae, 0xe3, 0x28, 0x09, 0x1b, 0x58,
+            0xfa, 0xb3, 0x24, 0xe4, 0xfa, 0xd6, 0x75, 0x94, 0x55, 0x85, 0x80, 0x8b, 0x48, 0x31, 0xd7, 0xbc,
+            0x3f, 0xf4, 0xde, 0xf0, 0x8e, 0x4b, 0x7a, 0x9d, 0xe5, 0x76, 0xd2, 0x65, 0x86, 0xce, 0xc6, 0x4b,
+            0x61, 0x16};
+        const uint8_t tag[AEAD_TAG_SIZE] = {0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a,
+                                            0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91};
+        uint8_t key[AEAD_KEY_SIZE];
+        for (size_t i = 0; i < AEAD_KEY_SIZE; ++i) {
+            key[i] = static_cast<uint8_t>(0x80 + i);
+        }
+        ChaCha20Poly1305 cipher(key);
+
+        uint8_t data[sizeof(ciphertext)];
+        std::memcpy(data, plaintext, sizeof(data));
+        uint8_t sealedTag[AEAD_TAG_SIZE];
+        cipher.seal(nonce, aad, sizeof(aad), data, sizeof(data), sealedTag);
+        check(std::memcmp(data, ciphertext, sizeof(data)) == 0, "the RFC 8439 ciphertext differs", kernel);
+        check(std::memcmp(sealedTag, tag, sizeof(tag)) == 0, "the RFC 8439 tag differs", kernel);
+
+        check(cipher.open(nonce, aad, sizeof(aad), data, sizeof(data), tag), "the RFC 8439 message was rejected",
+              kernel);
+        check(std::memcmp(data, plaintext, sizeof(data)) == 0, "the RFC 8439 message did not decrypt", kernel);
+
+        std::memcpy(data, ciphertext, sizeof(data));
+        data[sizeof(data) - 1] ^= 1;
+        check(!cipher.open(nonce, aad, sizeof(aad), data, sizeof(data), tag), "an altered message was accepted",
+              kernel);
+    }
+
+    /**
+     * @brief Seals every message on its own with the current kernel.
+     */
+    std::vector<Sealed> sealEach(const std::vector<Message>& input, const ChaCha20Poly1305 *ciphers) {
+        std::vector<Sealed> result(input.size());
+        for (size_t i = 0; i < input.size(); ++i) {
+            const Message& message = input[i];
+            result[i].data = message.plaintext;
+            ciphers[message.key].seal(message.nonce, message.aad, sizeof(message.aad), result[i].data.data(),
+                                      result[i].data.size(), result[i].tag);
+        }
+        return result;
+    }
+
+    void kernelsAgree(const char *kernel, const std::vector<Message>& input, const ChaCha20Poly1305 *ciphers,
+                      const std::vector<Sealed>& expected) {
+        std::vector<Sealed> single = sealEach(input, ciphers);
+        for (size_t i = 0; i < input.size(); ++i) {
+            check(single[i].data == expected[i].data, "seal() differs from the scalar kernel", kernel);
+            check(std::memcmp(single[i].tag, expected[i].tag, AEAD_TAG_SIZE) == 0,
+                  "the tag of seal() differs from the scalar kernel", kernel);
+        }
+
+        std::vector<Sealed> batch(input.size());
+        std::vector<AeadMessage> batchMessages(input.size());
+        for (size_t i = 0; i < input.size(); ++i) {
+            batch[i].data = input[i].plaintext;
+            AeadMessage& message = batchMessages[i];
+            message.cipher = &ciphers[input[i].key];
+            message.nonce = input[i].nonce;
+            message.aad = input[i].aad;
+            message.aadLength = sizeof(input[i].aad);
+            message.data = batch[i].data.data();
+            message.length = batch[i].data.size();
+            message.tag = batch[i].tag;
+        }
+        sealBatch(batchMessages.data(), batchMessages.size());
+        for (size_t i = 0; i < input.size(); ++i) {
+            check(batch[i].data == expected[i].data, "sealBatch() differs from the scalar kernel", kernel);
+            check(std::memcmp(batch[i].tag, expected[i].tag, AEAD_TAG_SIZE) == 0,
+                  "the tag of sealBatch() differs from the scalar kernel", kernel);
+        }
+
+        // One altered message must fail alone and stay encrypted; the others decrypt.
+        const size_t altered = input.size() / 2;
+        batch[altered].tag[0] ^= 1;
+        bool authentic[sizeof(LENGTHS) / sizeof(LENGTHS[0])];
+        size_t opened = openBatch(batchMessages.data(), batchMessages.size(), authentic);
+        check(opened == input.size() - 1, "openBatch() counted the wrong number of messages", kernel);
+        for (size_t i = 0; i < input.size(); ++i) {
+            if (i == altered) {
+                check(!authentic[i], "openBatch() accepted an altered tag", kernel);
+                check(batch[i].data == expected[i].data, "openBatch() decrypted an altered message", kernel);
+            } else {
+                check(authentic[i], "openBatch() rejected a message", kernel);
+                check(batch[i].data == input[i].plaintext, "openBatch() did not restore the plaintext", kernel);
+            }
+        }
+    }
+}
+
+int main() {
+    const char *detected = ChaCha20Poly1305::kernelName();
+
+    uint8_t keys[3][AEAD_KEY_SIZE];
+    for (size_t k = 0; k < 3; ++k) {
+        for (size_t i = 0; i < AEAD_KEY_SIZE; ++i) {
+            keys[k][i] = static_cast<uint8_t>(k * 67 + i * 13 + 1);
+        }
+    }
+    const ChaCha20Poly1305 ciphers[3] = {ChaCha20Poly1305(keys[0]), ChaCha20Poly1305(keys[1]),
+                                         ChaCha20Poly1305(keys[2])};
+    std::vector<Message> input = messages();
+
+    ChaCha20Poly1305::useKernel("scalar");
+    std::vector<Sealed> expected = sealEach(input, ciphers);
+
+    int tested = 0;
+    for (const char *kernel : KERNELS) {
+        if (!ChaCha20Poly1305::useKernel(kernel)) {
+            std::printf("%s: not available on this CPU or build\n", kernel);
+            continue;
+        }
+        rfc8439Vector(kernel);
+        kernelsAgree(kernel, input, ciphers, expected);
+        std::printf("%s: checked\n", kernel);
+        tested++;
+    }
+    ChaCha20Poly1305::useKernel(detected);
+
+    if (failures == 0) {
+        std::printf("%d kernels match RFC 8439 and each other\n", tested);
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -1,14 +1,20 @@
 #include <iostream>
 #include <thread>
 
+#ifdef _WIN32
 #include "WindowsTransport.h"
+using PlatformTransport = YunaProtocol::WindowsTransport;
+#else
+#include "LinuxTransport.h"
+using PlatformTransport = YunaProtocol::LinuxTransport;
+#endif
 #include "YunaNode.h"
 //
 // Created by youss on 6/14/2025.
 //
 int main(int argc, char *argv[]) {
     std::cout << "Hello, World!" << std::endl;
-    auto transport = std::make_unique<YunaProtocol::WindowsTransport>(42069);
+    auto transport = std::make_unique<PlatformTransport>(42069);
 
 
     transport->initialize();
@@ -0,0 +1,94 @@
+//
+// Created by youss on 10/19/2026.
+//
+// Replays encrypted packets captured across many restarts of their sender and checks that the
+// receiver rejects every one of them, while the sender's current session keeps getting through.
+//
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "ChannelCipher.h"
+#include "ReplayWindow.h"
+
+using namespace YunaProtocol;
+
+namespace {
+    constexpr uint32_t SENDER = 7;
+    constexpr uint32_t FIRST_SESSION = 1000;
+    constexpr int RESTARTS = 12;
+    const uint8_t KEY[AEAD_KEY_SIZE] = {1, 2, 3, 4, 5, 6, 7, 8};
+
+    int failures = 0;
+
+    void check(bool condition, const char *what) {
+        if (!condition) {
+            std::printf("FAIL: %s\n", what);
+            failures++;
+        }
+    }
+
+    Packet dataPacket(uint32_t sequence) {
+        Packet packet;
+        packet.header.packetType = DATA;
+        packet.header.sourceId = SENDER;
+        packet.header.sequence = sequence;
+        std::strcpy(packet.header.channel, "secret");
+        packet.payload.assign(16, static_cast<uint8_t>(sequence));
+        packet.header.payloadLength = static_cast<uint16_t>(packet.payload.size());
+        return packet;
+    }
+
+    void restartsThroughChannelCipher() {
+        ChannelCipher receiver;
+        receiver.setKey("secret", KEY);
+        std::vector<Packet> captured;
+        Packet plain;
+        for (int restart = 0; restart < RESTARTS; ++restart) {
+            // A restarted sender comes back with a higher session and its counter at 0.
+            ChannelCipher sender;
+            sender.setKey("secret", KEY);
+            sender.setSession(FIRST_SESSION + restart);
+            Packet packets[4] = {dataPacket(1), dataPacket(2), dataPacket(3), dataPacket(4)};
+            sender.seal(packets, 4);
+            for (const Packet &packet : packets) {
+                check(receiver.open(packet, plain), "a packet of the current session was rejected");
+                captured.push_back(packet);
+            }
+            // Everything captured so far, this session included, has been seen or is too old.
+            for (const Packet &packet : captured) {
+                check(!receiver.open(packet, plain), "a captured packet was accepted again");
+            }
+        }
+        EncryptionStats stats = receiver.getStats();
+        check(stats.opened == 4 * RESTARTS, "not every fresh packet was opened");
+        check(stats.authenticationFailures == 0, "a replayed packet failed authentication instead");
+    }
+
+    void olderSessionsNeverReplaceTheCurrentOne() {
+        ReplayWindow window;
+        auto nonce = [](uint32_t session, uint32_t counter) { return uint64_t{session} << 32 | counter; };
+        check(window.accept(SENDER, nonce(FIRST_SESSION + 10, 0)), "the first session was rejected");
+        // Sessions older than the current one, seen before or not, are all refused.
+        for (uint32_t session = FIRST_SESSION; session < FIRST_SESSION + 10; ++session) {
+            check(!window.accept(SENDER, nonce(session, 0)), "an older session was accepted");
+            check(!window.accept(SENDER, nonce(session, 100)), "an older session was accepted");
+        }
+        check(window.accept(SENDER, nonce(FIRST_SESSION + 10, 1)), "the current session stopped working");
+        check(!window.accept(SENDER, nonce(FIRST_SESSION + 10, 1)), "a replay within the session was accepted");
+        check(window.accept(SENDER, nonce(FIRST_SESSION + 11, 0)), "a newer session was rejected");
+        check(!window.accept(SENDER, nonce(FIRST_SESSION + 10, 2)), "the replaced session was accepted");
+        check(window.accept(SENDER + 1, nonce(FIRST_SESSION, 0)), "another source was affected");
+    }
+}
+
+int main() {
+    restartsThroughChannelCipher();
+    olderSessionsNeverReplaceTheCurrentOne();
+    if (failures == 0) {
+        std::printf("No replay accepted across %d sender restarts\n", RESTARTS);
+    }
+    return failures == 0 ? 0 : 1;
+}
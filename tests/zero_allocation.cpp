@@ -0,0 +1,254 @@
+//
+// Created by youss on 10/19/2026.
+//
+// Checks the fixed-footprint profile on the host: StaticNode over a PeerTable-backed transport must
+// not touch the heap once discovery has settled. Every allocation goes through the counting
+// operator new and, on glibc, malloc below; the test fails if any happens while packets are sent
+// and received. The transport stands in for ESP8266Transport with an in-memory medium, so the test
+// needs no network.
+//
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include "Packet.h"
+#include "PeerTable.h"
+#include "StaticNode.h"
+#include "YunaConfig.h"
+
+namespace {
+    std::atomic<size_t> allocations{0};
+}
+
+void *operator new(size_t size) {
+    allocations++;
+    void *memory = std::malloc(size ? size : 1);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void *operator new(size_t size, const std::nothrow_t&) noexcept {
+    allocations++;
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept {
+    std::free(memory);
+}
+
+#if defined(__GLIBC__)
+// Also catch C allocations, e.g. from the C library, by interposing glibc's allocator.
+extern "C" {
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t count, size_t size);
+    void *__libc_realloc(void *memory, size_t size);
+
+    void *malloc(size_t size) {
+        allocations++;
+        return __libc_malloc(size);
+    }
+
+    void *calloc(size_t count, size_t size) {
+        allocations++;
+        return __libc_calloc(count, size);
+    }
+
+    void *realloc(void *memory, size_t size) {
+        allocations++;
+        return __libc_realloc(memory, size);
+    }
+}
+#endif
+
+using namespace YunaProtocol;
+
+namespace {
+    constexpr size_t MAX_FRAME = sizeof(PacketHeader) + YUNA_MAX_PAYLOAD + PACKET_CHECKSUM_SIZE;
+    constexpr size_t INBOX_DEPTH = 64;
+
+    class MemoryTransport;
+
+    /**
+     * @brief The shared medium: a broadcast reaches every other attached transport.
+     */
+    struct MemoryBus {
+        MemoryTransport *members[YUNA_MAX_PEERS + 1] = {};
+        size_t count = 0;
+    };
+
+    /**
+     * @brief A transport like ESP8266Transport whose datagrams travel through memory.
+     *
+     * Peers live in a PeerTable and received frames in a fixed inbox, so it allocates nothing.
+     */
+    class MemoryTransport {
+    public:
+        explicit MemoryTransport(MemoryBus& bus) : bus(bus) {
+            bus.members[bus.count++] = this;
+        }
+
+        void setClientId(uint32_t id) {
+            clientID = id;
+        }
+
+        bool initialize() {
+            PacketView announce;
+            announce.header.packetType = DISCOVERY_PEER;
+            announce.header.sourceId = clientID;
+            bool sent = true;
+            for (size_t i = 0; i < bus.count; ++i) {
+                if (bus.members[i] != this) {
+                    sent = bus.members[i]->deliver(this, announce) && sent;
+                }
+            }
+            return sent;
+        }
+
+        template <typename Sink>
+        void poll(Sink& sink) {
+            for (; inboxCount > 0; inboxHead = (inboxHead + 1) % INBOX_DEPTH, inboxCount--) {
+                const Frame& frame = inbox[inboxHead];
+                PacketView packet;
+                if (packet.decode(frame.data, frame.size) != DecodeStatus::Ok) {
+                    continue;
+                }
+                if (!peers.find(packet.header.sourceId)) {
+                    peers.insert(packet.header.sourceId, frame.from);
+                }
+                if (packet.header.packetType != DISCOVERY_PEER) {
+                    sink(packet);
+                }
+            }
+        }
+
+        bool send(const PacketView& packet) {
+            bool sent = true;
+            for (const auto& peer : peers) {
+                sent = peer.address->deliver(this, packet) && sent;
+            }
+            return sent;
+        }
+
+        bool sendTo(uint32_t clientId, const PacketView& packet) {
+            MemoryTransport *const *peer = peers.find(clientId);
+            return peer && (*peer)->deliver(this, packet);
+        }
+
+        size_t peerCount() const {
+            return peers.size();
+        }
+
+    private:
+        struct Frame {
+            MemoryTransport *from;
+            size_t size;
+            uint8_t data[MAX_FRAME];
+        };
+
+        bool deliver(MemoryTransport *from, const PacketView& packet) {
+            if (inboxCount == INBOX_DEPTH) {
+                return false;
+            }
+            Frame& frame = inbox[(inboxHead + inboxCount) % INBOX_DEPTH];
+            frame.from = from;
+            frame.size = packet.serialize(frame.data, sizeof(frame.data));
+            if (frame.size == 0) {
+                return false;
+            }
+            inboxCount++;
+            return true;
+        }
+
+        MemoryBus& bus;
+        uint32_t clientID = 0;
+        PeerTable<MemoryTransport *, YUNA_MAX_PEERS> peers;
+        Frame inbox[INBOX_DEPTH];
+        size_t inboxHead = 0;
+        size_t inboxCount = 0;
+    };
+
+    struct Temperature {
+        static constexpr const char *channel = "sensors/+/temp";
+        uint32_t received = 0;
+
+        void operator()(const PacketView&) { received++; }
+    };
+
+    struct Everything {
+        static constexpr const char *channel = "#";
+        uint32_t received = 0;
+
+        void operator()(const PacketView&) { received++; }
+    };
+
+    using TestNode = StaticNode<ChannelHandlers<Temperature, Everything>, MemoryTransport>;
+
+    // Globals, like on a device, so their fixed storage is not on the stack.
+    MemoryBus bus;
+    MemoryTransport transports[] = {MemoryTransport(bus), MemoryTransport(bus), MemoryTransport(bus)};
+    TestNode nodes[] = {TestNode(1, transports[0]), TestNode(2, transports[1]), TestNode(3, transports[2])};
+    uint8_t payload[YUNA_MAX_PAYLOAD];
+
+    void loopAll() {
+        for (TestNode& node : nodes) {
+            node.loop();
+        }
+    }
+}
+
+int main() {
+    // Setup: initialize, let discovery settle, and warm up the send and receive paths once.
+    nodes[0].enableIntegrityCheck(true);
+    for (TestNode& node : nodes) {
+        node.initialize();
+    }
+    loopAll();
+    loopAll();
+    for (TestNode& node : nodes) {
+        node.sendData("sensors/a/temp", payload, 8);
+    }
+    loopAll();
+    for (const MemoryTransport& transport : transports) {
+        if (transport.peerCount() != 2) {
+            std::printf("FAIL: discovery did not settle, %zu peers known\n", transport.peerCount());
+            return 1;
+        }
+    }
+    uint32_t receivedBefore = nodes[1].handler<Temperature>().received;
+
+    size_t allocationsBefore = allocations.load();
+    for (int round = 0; round < 1000; ++round) {
+        nodes[0].sendData("sensors/a/temp", payload, 8);
+        nodes[1].sendData<Everything>(payload, 200);
+        nodes[2].sendData("sensors/b/temp", payload, YUNA_MAX_PAYLOAD);
+        // A probe, answered through PeerTable lookup and sendTo().
+        PacketView ping;
+        ping.header.packetType = PING;
+        ping.header.sourceId = 3;
+        transports[2].send(ping);
+        loopAll();
+    }
+    size_t allocationsDuring = allocations.load() - allocationsBefore;
+
+    uint32_t received = nodes[1].handler<Temperature>().received - receivedBefore;
+    std::printf("%u packets on sensors/+/temp, %zu allocations while sending and receiving\n", received,
+                allocationsDuring);
+    if (received != 2000) {
+        std::printf("FAIL: expected 2000 packets\n");
+        return 1;
+    }
+    if (allocationsDuring != 0) {
+        std::printf("FAIL: the steady-state path allocated\n");
+        return 1;
+    }
+    return 0;
+}